@@ -133,6 +133,21 @@ Global::BenchmarkTestData AppSettings::defaultBenchmarkTestData()
     return Global::BenchmarkTestData::Random;
 }
 
+Global::BenchmarkEngine AppSettings::getBenchmarkEngine() const
+{
+    return (Global::BenchmarkEngine)m_settings->value(QStringLiteral("Benchmark/Engine"), defaultBenchmarkEngine()).toInt();
+}
+
+void AppSettings::setBenchmarkEngine(Global::BenchmarkEngine benchmarkEngine)
+{
+    m_settings->setValue(QStringLiteral("Benchmark/Engine"), benchmarkEngine);
+}
+
+Global::BenchmarkEngine AppSettings::defaultBenchmarkEngine()
+{
+    return Global::BenchmarkEngine::FIO;
+}
+
 int AppSettings::getLoopsCount() const
 {
     return m_settings->value(QStringLiteral("Benchmark/LoopsCount"), defaultLoopsCount()).toInt();
@@ -163,6 +178,141 @@ int AppSettings::defaultFileSize()
     return 1024;
 }
 
+int AppSettings::getPreconditionPasses() const
+{
+    return m_settings->value(QStringLiteral("Benchmark/PreconditionPasses"), defaultPreconditionPasses()).toInt();
+}
+
+void AppSettings::setPreconditionPasses(int passes)
+{
+    m_settings->setValue(QStringLiteral("Benchmark/PreconditionPasses"), passes);
+}
+
+int AppSettings::defaultPreconditionPasses()
+{
+    return 0;
+}
+
+int AppSettings::getAdaptiveTargetCI() const
+{
+    return m_settings->value(QStringLiteral("Benchmark/AdaptiveTargetCI"), defaultAdaptiveTargetCI()).toInt();
+}
+
+void AppSettings::setAdaptiveTargetCI(int targetCI)
+{
+    m_settings->setValue(QStringLiteral("Benchmark/AdaptiveTargetCI"), targetCI);
+}
+
+int AppSettings::defaultAdaptiveTargetCI()
+{
+    return 0;
+}
+
+int AppSettings::getAdaptiveMaxLoops() const
+{
+    return m_settings->value(QStringLiteral("Benchmark/AdaptiveMaxLoops"), defaultAdaptiveMaxLoops()).toInt();
+}
+
+void AppSettings::setAdaptiveMaxLoops(int maxLoops)
+{
+    m_settings->setValue(QStringLiteral("Benchmark/AdaptiveMaxLoops"), maxLoops);
+}
+
+int AppSettings::defaultAdaptiveMaxLoops()
+{
+    return 30;
+}
+
+int AppSettings::getAdaptiveTimeBudget() const
+{
+    return m_settings->value(QStringLiteral("Benchmark/AdaptiveTimeBudget"), defaultAdaptiveTimeBudget()).toInt();
+}
+
+void AppSettings::setAdaptiveTimeBudget(int timeBudget)
+{
+    m_settings->setValue(QStringLiteral("Benchmark/AdaptiveTimeBudget"), timeBudget);
+}
+
+int AppSettings::defaultAdaptiveTimeBudget()
+{
+    return 600;
+}
+
+int AppSettings::getSteadyStateTimeBudget() const
+{
+    return m_settings->value(QStringLiteral("Benchmark/SteadyStateTimeBudget"), defaultSteadyStateTimeBudget()).toInt();
+}
+
+void AppSettings::setSteadyStateTimeBudget(int timeBudget)
+{
+    m_settings->setValue(QStringLiteral("Benchmark/SteadyStateTimeBudget"), timeBudget);
+}
+
+int AppSettings::defaultSteadyStateTimeBudget()
+{
+    return 600;
+}
+
+double AppSettings::getSLOPercentile() const
+{
+    return m_settings->value(QStringLiteral("Benchmark/SLOPercentile"), defaultSLOPercentile()).toDouble();
+}
+
+void AppSettings::setSLOPercentile(double percentile)
+{
+    m_settings->setValue(QStringLiteral("Benchmark/SLOPercentile"), percentile);
+}
+
+double AppSettings::defaultSLOPercentile()
+{
+    return 99;
+}
+
+int AppSettings::getSLOLatency() const
+{
+    return m_settings->value(QStringLiteral("Benchmark/SLOLatency"), defaultSLOLatency()).toInt();
+}
+
+void AppSettings::setSLOLatency(int latency)
+{
+    m_settings->setValue(QStringLiteral("Benchmark/SLOLatency"), latency);
+}
+
+int AppSettings::defaultSLOLatency()
+{
+    return 1000; // usec
+}
+
+int AppSettings::getCompressPercentage() const
+{
+    return m_settings->value(QStringLiteral("Benchmark/CompressPercentage"), defaultCompressPercentage()).toInt();
+}
+
+void AppSettings::setCompressPercentage(int percentage)
+{
+    m_settings->setValue(QStringLiteral("Benchmark/CompressPercentage"), percentage);
+}
+
+int AppSettings::defaultCompressPercentage()
+{
+    return 50; // 2:1
+}
+
+int AppSettings::getDedupePercentage() const
+{
+    return m_settings->value(QStringLiteral("Benchmark/DedupePercentage"), defaultDedupePercentage()).toInt();
+}
+
+void AppSettings::setDedupePercentage(int percentage)
+{
+    m_settings->setValue(QStringLiteral("Benchmark/DedupePercentage"), percentage);
+}
+
+int AppSettings::defaultDedupePercentage()
+{
+    return 0;
+}
+
 int AppSettings::getMeasuringTime() const
 {
     return m_settings->value(QStringLiteral("Benchmark/MeasuringTime"), defaultMeasuringTime()).toInt();
@@ -264,6 +414,47 @@ bool AppSettings::defaultCoWDetectionState()
     return true;
 }
 
+QVector<Workload> AppSettings::getWorkloads() const
+{
+    QVector<Workload> workloads;
+
+    int size = m_settings->beginReadArray(QStringLiteral("Workloads"));
+    for (int i = 0; i < size; i++) {
+        m_settings->setArrayIndex(i);
+        workloads << Workload::fromVariant(m_settings->value(QStringLiteral("Job")).toMap());
+    }
+    m_settings->endArray();
+
+    return workloads;
+}
+
+void AppSettings::setWorkloads(const QVector<Workload> &workloads)
+{
+    m_settings->remove(QStringLiteral("Workloads"));
+
+    m_settings->beginWriteArray(QStringLiteral("Workloads"), workloads.size());
+    for (int i = 0; i < workloads.size(); i++) {
+        m_settings->setArrayIndex(i);
+        m_settings->setValue(QStringLiteral("Job"), workloads.at(i).toVariant());
+    }
+    m_settings->endArray();
+}
+
+bool AppSettings::getKeepBenchmarkFileState() const
+{
+    return m_settings->value(QStringLiteral("Benchmark/KeepBenchmarkFile"), defaultKeepBenchmarkFileState()).toBool();
+}
+
+void AppSettings::setKeepBenchmarkFileState(bool state)
+{
+    m_settings->setValue(QStringLiteral("Benchmark/KeepBenchmarkFile"), state);
+}
+
+bool AppSettings::defaultKeepBenchmarkFileState()
+{
+    return false;
+}
+
 Global::ComparisonUnit AppSettings::getComparisonUnit() const
 {
     return (Global::ComparisonUnit)m_settings->value(QStringLiteral("Interface/ComparisonUnit"), defaultComparisonUnit()).toInt();
@@ -297,7 +488,7 @@ Global::Theme AppSettings::defaultTheme()
 Global::BenchmarkParams AppSettings::getBenchmarkParams(Global::BenchmarkTest test, Global::PerformanceProfile profile) const
 {
     Global::BenchmarkParams defaultSet = defaultBenchmarkParams(test, profile, Global::BenchmarkPreset::Standard);
-    if (profile == Global::PerformanceProfile::RealWorld) return defaultSet;
+    if (profile == Global::PerformanceProfile::RealWorld || profile == Global::PerformanceProfile::SteadyState) return defaultSet;
 
     QString settingKey = QStringLiteral("Benchmark/Params/%1/%2/%3")
             .arg(QMetaEnum::fromType<Global::PerformanceProfile>().valueToKey(profile))
@@ -371,6 +562,14 @@ Global::BenchmarkParams AppSettings::defaultBenchmarkParams(Global::BenchmarkTes
             case Global::BenchmarkTest::Test_1:
                 return { Global::BenchmarkIOPattern::SEQ, 1024,  8,  1 };
             }
+        case Global::PerformanceProfile::SteadyState:
+            switch (test)
+            {
+            case Global::BenchmarkTest::Test_1:
+                return { Global::BenchmarkIOPattern::SEQ,  128, 32,  1 };
+            case Global::BenchmarkTest::Test_2:
+                return { Global::BenchmarkIOPattern::RND,    4, 32,  1 };
+            }
     }
     Q_UNREACHABLE();
 }
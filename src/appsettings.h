@@ -3,8 +3,10 @@
 
 #include <QObject>
 #include <QLocale>
+#include <QVector>
 
 #include "global.h"
+#include "workload.h"
 
 class QTranslator;
 class QSettings;
@@ -43,10 +45,50 @@ public:
     void setBenchmarkTestData(Global::BenchmarkTestData benchmarkTestData);
     static Global::BenchmarkTestData defaultBenchmarkTestData();
 
+    Global::BenchmarkEngine getBenchmarkEngine() const;
+    void setBenchmarkEngine(Global::BenchmarkEngine benchmarkEngine);
+    static Global::BenchmarkEngine defaultBenchmarkEngine();
+
+    int getPreconditionPasses() const;
+    void setPreconditionPasses(int passes);
+    static int defaultPreconditionPasses();
+
     int getLoopsCount() const;
     void setLoopsCount(int loopsCount);
     static int defaultLoopsCount();
 
+    int getAdaptiveTargetCI() const;
+    void setAdaptiveTargetCI(int targetCI);
+    static int defaultAdaptiveTargetCI();
+
+    int getAdaptiveMaxLoops() const;
+    void setAdaptiveMaxLoops(int maxLoops);
+    static int defaultAdaptiveMaxLoops();
+
+    int getAdaptiveTimeBudget() const;
+    void setAdaptiveTimeBudget(int timeBudget);
+    static int defaultAdaptiveTimeBudget();
+
+    int getSteadyStateTimeBudget() const;
+    void setSteadyStateTimeBudget(int timeBudget);
+    static int defaultSteadyStateTimeBudget();
+
+    double getSLOPercentile() const;
+    void setSLOPercentile(double percentile);
+    static double defaultSLOPercentile();
+
+    int getSLOLatency() const;
+    void setSLOLatency(int latency);
+    static int defaultSLOLatency();
+
+    int getCompressPercentage() const;
+    void setCompressPercentage(int percentage);
+    static int defaultCompressPercentage();
+
+    int getDedupePercentage() const;
+    void setDedupePercentage(int percentage);
+    static int defaultDedupePercentage();
+
     int getFileSize() const;
     void setFileSize(int fileSize);
     static int defaultFileSize();
@@ -79,6 +121,13 @@ public:
     void setCoWDetectionState(bool state);
     static bool defaultCoWDetectionState();
 
+    QVector<Workload> getWorkloads() const;
+    void setWorkloads(const QVector<Workload> &workloads);
+
+    bool getKeepBenchmarkFileState() const;
+    void setKeepBenchmarkFileState(bool state);
+    static bool defaultKeepBenchmarkFileState();
+
     Global::ComparisonUnit getComparisonUnit() const;
     void setComparisonUnit(Global::ComparisonUnit comparisonUnit);
     static Global::ComparisonUnit defaultComparisonUnit();
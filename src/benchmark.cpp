@@ -2,6 +2,9 @@
 
 #include "global.h"
 
+#include <QElapsedTimer>
+#include <QFile>
+
 #include "helper_interface.h"
 
 Benchmark::Benchmark()
@@ -39,6 +42,21 @@ QString Benchmark::getBenchmarkFile()
     return m_dir;
 }
 
+void Benchmark::setExtraDirs(const QStringList &dirs)
+{
+    m_extraDirs = dirs;
+}
+
+QStringList Benchmark::getExtraDirs()
+{
+    return m_extraDirs;
+}
+
+bool Benchmark::isRawDevice()
+{
+    return m_dir.startsWith(QLatin1String("/dev/"));
+}
+
 void Benchmark::startTest(int blockSize, int queueDepth, int threads, const QString &rw, const QString &statusMessage)
 {
     const AppSettings settings;
@@ -47,10 +65,74 @@ void Benchmark::startTest(int blockSize, int queueDepth, int threads, const QStr
 
     unsigned int index = 0;
 
-    for (int i = 0; i < settings.getLoopsCount(); i++) {
+    QVector<Sample> samples;
+
+    // Finished loops and live progress are folded into the totals the same way
+    auto accumulate = [&] (PerformanceResult &read, PerformanceResult &write, const ParsedJob &result) {
+        switch (settings.getPerformanceProfile())
+        {
+            case Global::PerformanceProfile::Default:
+                read  += result.read;
+                write += result.write;
+            break;
+            case Global::PerformanceProfile::Peak:
+            case Global::PerformanceProfile::RealWorld:
+            case Global::PerformanceProfile::Demo:
+            case Global::PerformanceProfile::SteadyState:
+                read.updateWithBetterValues(result.read);
+                write.updateWithBetterValues(result.write);
+            break;
+        }
+    };
+
+    auto combine = [&] (const PerformanceResult &read, const PerformanceResult &write) {
+        if (rw.contains("read")) {
+            return read;
+        }
+        else if (rw.contains("write")) {
+            return write;
+        }
+        else {
+            float p = settings.getRandomReadPercentage();
+            return (read * p + write * (100.f - p)) / 100.f;
+        }
+    };
+
+    float sloIOPS = 0;
+    double peakIOPS = 0; // reads and writes together, of the best loop
+
+    auto publish = [&] (const PerformanceResult &read, const PerformanceResult &write, unsigned int count) {
+        PerformanceResult result = combine(read, write);
+        result.Samples = samples;
+        result.SLOIOPS = sloIOPS;
+        sendResult(result, count);
+    };
+
+    const bool steadyState = settings.getPerformanceProfile() == Global::PerformanceProfile::SteadyState;
+
+    int measuringTime = settings.getMeasuringTime();
+    QVariantMap options;
+
+    if (steadyState) {
+        // SNIA-style window of five rounds in which every IOPS sample stays within 10% of the mean,
+        // fio stops the job once that holds, or when the time budget is used up
+        options["time_based"] = "1";
+        options["steadystate"] = "iops:10%";
+        options["steadystate_duration"] = QString::number(measuringTime * 5);
+        measuringTime = qMax(settings.getSteadyStateTimeBudget(), measuringTime * 5);
+    }
+
+    // In adaptive mode the loop count is only an upper bound, a steady state run is a single long loop
+    const int targetCI = steadyState ? 0 : settings.getAdaptiveTargetCI();
+    const int loopsCount = steadyState ? 1 : targetCI > 0 ? settings.getAdaptiveMaxLoops() : settings.getLoopsCount();
+
+    QElapsedTimer elapsedTimer;
+    elapsedTimer.start();
+
+    for (int i = 0; i < loopsCount; i++) {
         if (!m_running) break;
 
-        emit benchmarkStatusUpdate(statusMessage.arg(index + 1).arg(settings.getLoopsCount()));
+        emit benchmarkStatusUpdate(statusMessage.arg(index + 1).arg(loopsCount));
 
         auto interface = helperInterface();
         if (!interface) {
@@ -65,21 +147,7 @@ void Benchmark::startTest(int blockSize, int queueDepth, int threads, const QStr
 
         if (!isRunning()) return;
 
-        handleDbusPendingCall(interface->startBenchmarkTest(settings.getMeasuringTime(),
-                                                            settings.getFileSize(),
-                                                            settings.getRandomReadPercentage(),
-                                                            settings.getBenchmarkTestData() == Global::BenchmarkTestData::Zeros,
-                                                            settings.getCacheBypassState(),
-                                                            settings.getContinuousGenerationState(),
-                                                            blockSize, queueDepth, threads, rw));
-
-        if (!isRunning()) return;
-
-        QEventLoop loop;
-
         auto exitLoop = [&] (bool success, QString output, QString errorOutput) {
-            loop.exit();
-
             if (!success) {
                 setRunning(false);
             }
@@ -87,43 +155,141 @@ void Benchmark::startTest(int blockSize, int queueDepth, int threads, const QStr
             if (m_running) {
                 index++;
 
-                auto result = parseResult(output, errorOutput);
-
-                switch (settings.getPerformanceProfile())
-                {
-                    case Global::PerformanceProfile::Default:
-                        totalRead  += result.read;
-                        totalWrite += result.write;
-                    break;
-                    case Global::PerformanceProfile::Peak:
-                    case Global::PerformanceProfile::RealWorld:
-                    case Global::PerformanceProfile::Demo:
-                        totalRead.updateWithBetterValues(result.read);
-                        totalWrite.updateWithBetterValues(result.write);
-                    break;
-                }
-            }
+                ParsedJob result = parseResult(output, errorOutput);
+                accumulate(totalRead, totalWrite, result);
 
-            if (rw.contains("read")) {
-                sendResult(totalRead, index);
-            }
-            else if (rw.contains("write")) {
-                sendResult(totalWrite, index);
-            }
-            else if (rw.contains("rw")) {
-                float p = settings.getRandomReadPercentage();
-                sendResult((totalRead * p + totalWrite * (100.f - p)) / 100.f, index);
+                PerformanceResult sample = combine(result.read, result.write);
+                samples.append({ sample.Bandwidth, sample.IOPS, sample.Latency });
+
+                peakIOPS = qMax(peakIOPS, double(result.read.IOPS + result.write.IOPS));
             }
+
+            publish(totalRead, totalWrite, index);
         };
 
-        auto conn = QObject::connect(interface, &DevJonmagonKdiskmarkHelperInterface::taskFinished, exitLoop);
+        const QString series = statusMessage.arg(index + 1).arg(loopsCount);
+        double lastKBytes = 0, lastRuntime = 0;
 
-        loop.exec();
+        // Running totals of the current loop, shown as if the loop had already finished
+        auto progress = [&] (QString output) {
+            if (!m_running) return;
 
-        QObject::disconnect(conn);
+            ParsedJob current = parseProgress(output);
+            if (current.runtime <= lastRuntime) return;
+
+            PerformanceResult read = totalRead, write = totalWrite;
+            accumulate(read, write, current);
+            publish(read, write, index + 1);
+
+            emit liveSampleReady(series, index, current.runtime / 1000.0,
+                                 (current.ioKBytes - lastKBytes) / (current.runtime - lastRuntime)); // KiB/ms to mb
+
+            lastKBytes = current.ioKBytes;
+            lastRuntime = current.runtime;
+        };
+
+        runHelperTask(interface, [&] {
+            return interface->startBenchmarkTest(measuringTime,
+                                                 settings.getFileSize(),
+                                                 settings.getRandomReadPercentage(),
+                                                 settings.getBenchmarkTestData() == Global::BenchmarkTestData::Zeros,
+                                                 settings.getCacheBypassState(),
+                                                 settings.getContinuousGenerationState(),
+                                                 blockSize, queueDepth, threads, rw,
+                                                 Global::getBenchmarkEngineName(settings.getBenchmarkEngine()),
+                                                 withTestData(options));
+        }, exitLoop, progress);
+
+        if (targetCI > 0) {
+            if (isConverged(samples, targetCI)) break;
+            if (elapsedTimer.elapsed() / 1000 >= settings.getAdaptiveTimeBudget()) break;
+        }
+    }
+
+    // The unlimited loops above set the ceiling of the search and keep what the other units show
+    if (settings.getComparisonUnit() == Global::ComparisonUnit::SLOIOPS && m_running) {
+        LatencyHistogram peak = totalRead.Histogram;
+        peak.merge(totalWrite.Histogram);
+
+        sloIOPS = searchSLOIOPS({ rw, blockSize, queueDepth, threads, {} }, peakIOPS, peak, statusMessage);
+        publish(totalRead, totalWrite, index);
     }
 }
 
+float Benchmark::searchSLOIOPS(TestSpec spec, double peakIOPS, const LatencyHistogram &peak, const QString &statusMessage)
+{
+    const AppSettings settings;
+
+    // Each probe halves the interval, six of them get within 2% of the peak
+    const int probes = 6;
+    // A probe that falls short of its offered load did not sustain it, whatever its latency
+    const double heldShare = 0.95;
+
+    const double percentile = settings.getSLOPercentile();
+    const uint64_t bound = uint64_t(settings.getSLOLatency()) * 1000; // to nsec
+
+    if (peakIOPS <= 0) return 0;
+    if (!peak.isEmpty() && peak.percentile(percentile) <= bound) return peakIOPS;
+
+    double low = 0, high = peakIOPS;
+    float best = 0;
+
+    for (int i = 0; i < probes; i++) {
+        const double offered = (low + high) / 2;
+        spec.options["rate_iops"] = rateIOPS(spec.rw, settings.getRandomReadPercentage(), spec.threads, offered);
+
+        ParsedJob job;
+        if (!measure(spec, job, statusMessage.arg(tr("SLO %1").arg(i + 1)).arg(probes))) break;
+
+        const double achieved = job.read.IOPS + job.write.IOPS;
+        LatencyHistogram histogram = job.read.Histogram;
+        histogram.merge(job.write.Histogram);
+
+        if (!histogram.isEmpty() && histogram.percentile(percentile) <= bound && achieved >= offered * heldShare) {
+            low = offered;
+            best = achieved;
+        }
+        else {
+            high = offered;
+        }
+    }
+
+    return best;
+}
+
+bool Benchmark::isConverged(const QVector<Sample> &samples, int targetCI)
+{
+    // A couple of loops agreeing by chance should not end the test
+    if (samples.size() < 3) return false;
+
+    float Sample::*field = &Sample::Bandwidth;
+
+    switch (AppSettings().getComparisonUnit())
+    {
+        case Global::ComparisonUnit::IOPS:
+        case Global::ComparisonUnit::SLOIOPS:
+            field = &Sample::IOPS;
+        break;
+        case Global::ComparisonUnit::Latency:
+            field = &Sample::Latency;
+        break;
+        default:
+        break;
+    }
+
+    return summarize(samples, field).relativeCI() * 100 < targetCI;
+}
+
+Statistics::Summary Benchmark::summarize(const QVector<Sample> &samples, float Sample::*field)
+{
+    QVector<double> values;
+    for (const Sample &sample : samples) {
+        values << sample.*field;
+    }
+
+    return Statistics::summarize(values);
+}
+
 void Benchmark::sendResult(const Benchmark::PerformanceResult &result, const int index)
 {
     const AppSettings settings;
@@ -139,11 +305,147 @@ void Benchmark::sendResult(const Benchmark::PerformanceResult &result, const int
     }
 }
 
-Benchmark::ParsedJob Benchmark::parseResult(const QString &output, const QString &errorOutput)
+QJsonArray Benchmark::jobsFromOutput(const QString &output)
 {
     QJsonDocument jsonResponse = QJsonDocument::fromJson(output.toUtf8());
     QJsonObject jsonObject = jsonResponse.object();
-    QJsonArray jobs = jsonObject["jobs"].toArray();
+    // A persistent FIO session reports through the client, which lists jobs as client_stats
+    return jsonObject.contains("client_stats") ? jsonObject["client_stats"].toArray() : jsonObject["jobs"].toArray();
+}
+
+void Benchmark::addBins(LatencyHistogram &histogram, const QJsonObject &clat)
+{
+    // json+ output, keys are bucket values in ns
+    QJsonObject bins = clat["bins"].toObject();
+
+    for (auto it = bins.constBegin(); it != bins.constEnd(); ++it) {
+        histogram.add(it.key().toULongLong(), it.value().toVariant().toULongLong());
+    }
+}
+
+QVariantMap Benchmark::withTestData(QVariantMap options)
+{
+    const AppSettings settings;
+
+    if (settings.getBenchmarkTestData() == Global::BenchmarkTestData::Compressible) {
+        options["buffer_compress_percentage"] = QString::number(settings.getCompressPercentage());
+        options["dedupe_percentage"] = QString::number(settings.getDedupePercentage());
+    }
+
+    return options;
+}
+
+int Benchmark::targetIndex(const QJsonObject &job)
+{
+    // Set by the helper when several targets run together
+    const QString name = job.value("jobname").toString();
+    return name.startsWith(QLatin1String("target")) ? name.mid(6).toInt() : -1;
+}
+
+int Benchmark::targetsCount(const QJsonArray &jobs)
+{
+    int count = 0;
+
+    for (const QJsonValue &job : jobs) {
+        count = qMax(count, targetIndex(job.toObject()) + 1);
+    }
+
+    return count;
+}
+
+void Benchmark::addJob(Benchmark::ParsedJob &parsedJob, const QJsonObject &job, int jobsCount, int targetsCount)
+{
+    QJsonObject jobRead = job["read"].toObject();
+    QJsonObject jobWrite = job["write"].toObject();
+
+    // Steady state runs report the average over the final window instead of the whole run
+    double scale = 1;
+    QJsonObject steadyState = job["steadystate"].toObject();
+
+    if (!steadyState.isEmpty()) {
+        QJsonObject data = steadyState["data"].toObject();
+
+        double iops = jobRead.value("iops").toDouble() + jobWrite.value("iops").toDouble();
+        if (iops > 0 && data.value("iops_mean").toDouble() > 0) {
+            scale = data.value("iops_mean").toDouble() / iops;
+        }
+
+        // fio checks the range, the SNIA slope criterion is checked here on the same window
+        QVector<double> window;
+        for (const QJsonValue &value : data["iops"].toArray()) {
+            window << value.toDouble();
+        }
+
+        bool attained = steadyState.value("attained").toInt() == 1
+                && (window.size() < 2 || Statistics::relativeExcursion(window) <= 0.1);
+
+        float time = (job.contains("job_runtime") ? job.value("job_runtime").toDouble()
+                                                  : qMax(jobRead.value("runtime").toDouble(), jobWrite.value("runtime").toDouble())) / 1000.0;
+
+        parsedJob.read.SteadyStateTime = PerformanceResult::mergeSteadyStateTime(parsedJob.read.SteadyStateTime, attained ? time : -time);
+        parsedJob.write.SteadyStateTime = parsedJob.read.SteadyStateTime;
+    }
+
+    parsedJob.read.Bandwidth += jobRead.value("bw").toInt() / 1000.0 * scale; // to mb
+    parsedJob.read.IOPS += jobRead.value("iops").toDouble() * scale;
+    parsedJob.read.Latency += jobRead["clat_ns"].toObject().value("mean").toDouble() / 1000.0 / jobsCount; // to usec
+    addBins(parsedJob.read.Histogram, jobRead["clat_ns"].toObject());
+
+    parsedJob.write.Bandwidth += jobWrite.value("bw").toInt() / 1000.0 * scale; // to mb
+    parsedJob.write.IOPS += jobWrite.value("iops").toDouble() * scale;
+    parsedJob.write.Latency += jobWrite["clat_ns"].toObject().value("mean").toDouble() / 1000.0 / jobsCount; // to usec
+    addBins(parsedJob.write.Histogram, jobWrite["clat_ns"].toObject());
+
+    int target = targetIndex(job);
+
+    if (targetsCount > 1 && target >= 0 && target < targetsCount) {
+        // Every target runs the same number of jobs
+        const int targetJobsCount = qMax(1, jobsCount / targetsCount);
+
+        for (PerformanceResult *result : { &parsedJob.read, &parsedJob.write }) {
+            if (result->Targets.size() < targetsCount) result->Targets.resize(targetsCount);
+        }
+
+        Sample &read = parsedJob.read.Targets[target];
+        read.Bandwidth += jobRead.value("bw").toInt() / 1000.0 * scale; // to mb
+        read.IOPS += jobRead.value("iops").toDouble() * scale;
+        read.Latency += jobRead["clat_ns"].toObject().value("mean").toDouble() / 1000.0 / targetJobsCount; // to usec
+
+        Sample &write = parsedJob.write.Targets[target];
+        write.Bandwidth += jobWrite.value("bw").toInt() / 1000.0 * scale; // to mb
+        write.IOPS += jobWrite.value("iops").toDouble() * scale;
+        write.Latency += jobWrite["clat_ns"].toObject().value("mean").toDouble() / 1000.0 / targetJobsCount; // to usec
+    }
+
+    // fio only counts the sync calls, the rate comes from the job's own runtime
+    QJsonObject jobSync = job["sync"].toObject();
+    const double jobRuntime = job.contains("job_runtime") ? job.value("job_runtime").toDouble()
+                                                          : qMax(jobRead.value("runtime").toDouble(), jobWrite.value("runtime").toDouble());
+
+    if (jobRuntime > 0) parsedJob.sync.IOPS += jobSync.value("total_ios").toDouble() * 1000 / jobRuntime;
+    parsedJob.sync.Latency += jobSync["lat_ns"].toObject().value("mean").toDouble() / 1000.0 / jobsCount; // to usec
+    addBins(parsedJob.sync.Histogram, jobSync["lat_ns"].toObject());
+
+    parsedJob.ioKBytes += jobRead.value("io_kbytes").toDouble() + jobWrite.value("io_kbytes").toDouble();
+    parsedJob.runtime = qMax(parsedJob.runtime, qMax(jobRead.value("runtime").toDouble(), jobWrite.value("runtime").toDouble()));
+}
+
+Benchmark::ParsedJob Benchmark::parseProgress(const QString &output)
+{
+    QJsonArray jobs = jobsFromOutput(output);
+
+    ParsedJob parsedJob {{0, 0, 0}, {0, 0, 0}};
+
+    for (int i = 0; i < jobs.count(); i++) {
+        addJob(parsedJob, jobs.at(i).toObject(), jobs.count(), targetsCount(jobs));
+    }
+
+    return parsedJob;
+}
+
+Benchmark::ParsedJob Benchmark::parseResult(const QString &output, const QString &errorOutput)
+{
+    QJsonArray jobs = jobsFromOutput(output);
 
     ParsedJob parsedJob {{0, 0, 0}, {0, 0, 0}};
 
@@ -159,18 +461,10 @@ Benchmark::ParsedJob Benchmark::parseResult(const QString &output, const QString
     }
     else {
         for (int i = 0; i < jobsCount; i++) {
-            QJsonObject job = jobs.takeAt(i).toObject();
+            QJsonObject job = jobs.at(i).toObject();
 
             if (job["error"].toInt() == 0) {
-                QJsonObject jobRead = job["read"].toObject();
-                parsedJob.read.Bandwidth += jobRead.value("bw").toInt() / 1000.0; // to mb
-                parsedJob.read.IOPS += jobRead.value("iops").toDouble();
-                parsedJob.read.Latency += jobRead["clat_ns"].toObject().value("mean").toDouble() / 1000.0 / jobsCount; // to usec
-
-                QJsonObject jobWrite = job["write"].toObject();
-                parsedJob.write.Bandwidth += jobWrite.value("bw").toInt() / 1000.0; // to mb
-                parsedJob.write.IOPS += jobWrite.value("iops").toDouble();
-                parsedJob.write.Latency += jobWrite["clat_ns"].toObject().value("mean").toDouble() / 1000.0 / jobsCount; // to usec
+                addJob(parsedJob, job, jobsCount, targetsCount(jobs));
             }
             else {
                 setRunning(false);
@@ -216,6 +510,7 @@ void Benchmark::runBenchmark(QList<QPair<QPair<Global::BenchmarkTest, Global::Be
         item = iter.next();
         if (item.first.second == Global::BenchmarkIOReadWrite::Read && settings.getBenchmarkMode() == Global::BenchmarkMode::WriteMix) { iter.remove(); continue; }
         if (item.first.second == Global::BenchmarkIOReadWrite::Write && settings.getBenchmarkMode() == Global::BenchmarkMode::ReadMix) { iter.remove(); continue; }
+        if (item.first.second != Global::BenchmarkIOReadWrite::Read && isRawDevice()) { iter.remove(); continue; }
         auto progressBars = item.second;
         for (auto obj : progressBars) {
             emit resultReady(obj, PerformanceResult());
@@ -230,15 +525,7 @@ void Benchmark::runBenchmark(QList<QPair<QPair<Global::BenchmarkTest, Global::Be
         return;
     }
 
-    emit benchmarkStatusUpdate(tr("Preparing..."));
-
-    initSession(); if (!isRunning()) return;
-
-    if (AppSettings().getCoWDetectionState()) {
-        prepareDirectory(getBenchmarkFile()); if (!isRunning()) return;
-    }
-
-    prepareFile(getBenchmarkFile(), settings.getFileSize());
+    if (!beginRun()) return;
 
     while (iter.hasNext() && isRunning()) {
         item = iter.next();
@@ -291,6 +578,44 @@ void Benchmark::runBenchmark(QList<QPair<QPair<Global::BenchmarkTest, Global::Be
         }
     }
 
+    endRun();
+}
+
+bool Benchmark::beginRun()
+{
+    const AppSettings settings;
+
+    emit benchmarkStatusUpdate(tr("Preparing..."));
+
+    initSession(); if (!isRunning()) return false;
+
+    // Nothing to create, fill or precondition, and other targets are not combined with a raw device
+    if (isRawDevice()) {
+        prepareRawDevice(getBenchmarkFile());
+        return isRunning();
+    }
+
+    if (settings.getCoWDetectionState()) {
+        prepareDirectory(getBenchmarkFile()); if (!isRunning()) return false;
+    }
+
+    prepareFile(getBenchmarkFile(), settings.getFileSize());
+
+    // Every test then runs on all targets at once
+    for (const QString &dir : m_extraDirs) {
+        if (!isRunning()) break;
+        prepareFile(dir, settings.getFileSize());
+    }
+
+    if (settings.getPreconditionPasses() > 0 && isRunning()) {
+        precondition(settings.getPreconditionPasses());
+    }
+
+    return isRunning();
+}
+
+void Benchmark::endRun()
+{
     auto interface = helperInterface();
     if (interface) handleDbusPendingCall(interface->removeBenchmarkFile());
 
@@ -303,6 +628,234 @@ void Benchmark::runBenchmark(QList<QPair<QPair<Global::BenchmarkTest, Global::Be
     emit finished(); // Only needed when closing the app during a running benchmarking
 }
 
+void Benchmark::runTool(const std::function<void()> &body)
+{
+    setRunning(true);
+
+    if (beginRun()) body();
+
+    endRun();
+}
+
+QString Benchmark::rateIOPS(const QString &rw, int readPercentage, int threads, double iops)
+{
+    // fio applies the rate to every job, and a zero would lift the limit
+    const int jobs = threads * (isRawDevice() ? 1 : 1 + m_extraDirs.size());
+
+    auto perJob = [jobs] (double value) {
+        return QString::number(qMax(qint64(1), qRound64(value / jobs)));
+    };
+
+    if (rw.contains("read") || rw.contains("write")) return perJob(iops);
+
+    return perJob(iops * readPercentage / 100) + ',' + perJob(iops * (100 - readPercentage) / 100);
+}
+
+bool Benchmark::measure(const TestSpec &spec, PerformanceResult &result, const QString &statusMessage)
+{
+    const AppSettings settings;
+
+    result = PerformanceResult { 0, 0, 0 };
+
+    ParsedJob job;
+    if (!measure(spec, job, statusMessage)) return false;
+
+    if (spec.rw.contains("read")) {
+        result = job.read;
+    }
+    else if (spec.rw.contains("write")) {
+        result = job.write;
+    }
+    else {
+        float p = spec.readPercentage >= 0 ? spec.readPercentage : settings.getRandomReadPercentage();
+        result = (job.read * p + job.write * (100.f - p)) / 100.f;
+    }
+
+    return true;
+}
+
+bool Benchmark::measure(const TestSpec &spec, ParsedJob &job, const QString &statusMessage)
+{
+    const AppSettings settings;
+
+    job = ParsedJob {{0, 0, 0}, {0, 0, 0}};
+
+    if (!isRunning()) return false;
+
+    emit benchmarkStatusUpdate(statusMessage);
+
+    auto interface = helperInterface();
+    if (!interface) {
+        setRunning(false);
+        emit failed("Helper inteface is null.");
+        return false;
+    }
+
+    if (settings.getFlusingCacheState()) {
+        handleDbusPendingCall(interface->flushPageCache());
+    }
+
+    if (!isRunning()) return false;
+
+    // fio takes a runtime of 0 as no limit
+    const int measuringTime = spec.measuringTime < 0 ? 0 : spec.measuringTime > 0 ? spec.measuringTime : settings.getMeasuringTime();
+    const int readPercentage = spec.readPercentage >= 0 ? spec.readPercentage : settings.getRandomReadPercentage();
+
+    auto exitLoop = [&] (bool success, QString output, QString errorOutput) {
+        if (!success) {
+            setRunning(false);
+        }
+
+        if (!isRunning()) return;
+
+        job = parseResult(output, errorOutput);
+    };
+
+    runHelperTask(interface, [&] {
+        return interface->startBenchmarkTest(measuringTime,
+                                             settings.getFileSize(),
+                                             readPercentage,
+                                             settings.getBenchmarkTestData() == Global::BenchmarkTestData::Zeros,
+                                             settings.getCacheBypassState(),
+                                             settings.getContinuousGenerationState(),
+                                             spec.blockSize, spec.queueDepth, spec.threads, spec.rw,
+                                             Global::getBenchmarkEngineName(settings.getBenchmarkEngine()),
+                                             withTestData(spec.options));
+    }, exitLoop);
+
+    return isRunning();
+}
+
+bool Benchmark::loadTrace(const QString &fileName, int speed, QVariantMap &summary)
+{
+    if (!isRunning()) return false;
+
+    auto interface = helperInterface();
+    if (!interface) {
+        setRunning(false);
+        emit failed("Helper inteface is null.");
+        return false;
+    }
+
+    // Opened here, so the helper never reads a file the user could not
+    QFile trace(fileName);
+    if (!trace.open(QIODevice::ReadOnly)) {
+        setRunning(false);
+        emit failed(tr("Cannot open the trace: %1").arg(trace.errorString()));
+        return false;
+    }
+
+    QDBusPendingCall pcall = interface->loadTrace(QDBusUnixFileDescriptor(trace.handle()), speed);
+    handleDbusPendingCall(pcall);
+    if (!isRunning()) return false;
+
+    QDBusPendingReply<QVariantMap> reply = pcall;
+    summary = reply.value();
+
+    return true;
+}
+
+bool Benchmark::prepareFileSet(int files, int fileSize)
+{
+    if (!isRunning()) return false;
+
+    auto interface = helperInterface();
+    if (!interface) {
+        setRunning(false);
+        emit failed("Helper inteface is null.");
+        return false;
+    }
+
+    const AppSettings settings;
+    const QVariantMap testData = withTestData({});
+
+    emit benchmarkStatusUpdate(tr("Creating files... %1%").arg(0));
+
+    auto exitLoop = [&] (bool success, QString output, QString errorOutput) {
+        if (!isRunning()) return;
+
+        if (!success) {
+            setRunning(false);
+            emit failed(!errorOutput.isEmpty() ? errorOutput : "The file set could not be prepared.");
+        }
+
+        parseResult(output, errorOutput);
+    };
+
+    const double totalKBytes = double(files) * fileSize;
+
+    auto progress = [&] (QString output) {
+        if (!isRunning()) return;
+
+        emit benchmarkStatusUpdate(tr("Creating files... %1%").arg(qMin(100, int(parseProgress(output).ioKBytes * 100 / totalKBytes))));
+    };
+
+    runHelperTask(interface, [&] {
+        return interface->prepareFileSet(files, fileSize, settings.getBenchmarkTestData() == Global::BenchmarkTestData::Zeros,
+                                         testData.value("buffer_compress_percentage").toInt(),
+                                         testData.value("dedupe_percentage").toInt());
+    }, exitLoop, progress);
+
+    return isRunning();
+}
+
+bool Benchmark::measureMetadata(int files, int filesPerDirectory, int threads, QVector<MetadataPhase> &phases)
+{
+    phases.clear();
+
+    if (!isRunning()) return false;
+
+    auto interface = helperInterface();
+    if (!interface) {
+        setRunning(false);
+        emit failed("Helper inteface is null.");
+        return false;
+    }
+
+    emit benchmarkStatusUpdate(tr("Metadata test"));
+
+    auto exitLoop = [&] (bool success, QString output, QString errorOutput) {
+        if (!isRunning()) return;
+
+        if (!success) {
+            setRunning(false);
+            emit failed(!errorOutput.isEmpty() ? errorOutput : "The metadata test failed.");
+            return;
+        }
+
+        const QJsonArray results = QJsonDocument::fromJson(output.toUtf8()).object()["phases"].toArray();
+        for (const QJsonValue &value : results) {
+            const QJsonObject result = value.toObject();
+            const QJsonObject lat = result["lat_ns"].toObject();
+
+            MetadataPhase phase;
+            phase.operation = result["operation"].toString();
+            phase.cold = result["cold"].toBool();
+            phase.opsPerSecond = result["ops_per_sec"].toDouble();
+            phase.latency = lat["mean"].toDouble() / 1000;
+            addBins(phase.histogram, lat);
+
+            phases << phase;
+        }
+    };
+
+    auto progress = [&] (QString output) {
+        if (!isRunning()) return;
+
+        const QJsonObject report = QJsonDocument::fromJson(output.toUtf8()).object();
+        const double total = report["total"].toDouble();
+
+        emit benchmarkStatusUpdate(tr("Metadata test %1/%2: %3%").arg(report["phase"].toInt() + 1).arg(report["phases"].toInt())
+                                   .arg(total > 0 ? qMin(100, int(report["ops"].toDouble() * 100 / total)) : 0));
+    };
+
+    runHelperTask(interface, [&] {
+        return interface->startMetadataTest(files, filesPerDirectory, threads);
+    }, exitLoop, progress);
+
+    return isRunning();
+}
+
 DevJonmagonKdiskmarkHelperInterface* Benchmark::helperInterface()
 {
     if (!QDBusConnection::systemBus().isConnected()) {
@@ -365,30 +918,128 @@ void Benchmark::prepareFile(const QString &benchmarkFile, int fileSize)
     auto interface = helperInterface();
     if (!interface) return;
 
-    handleDbusPendingCall(interface->prepareBenchmarkFile(benchmarkFile, fileSize, AppSettings().getBenchmarkTestData() == Global::BenchmarkTestData::Zeros));
+    const AppSettings settings;
+    const QVariantMap testData = withTestData({});
+
+    auto exitLoop = [&] (bool success, QString output, QString errorOutput) {
+        if (!isRunning()) return;
+
+        if (!success) {
+            setRunning(false);
+            emit failed(!errorOutput.isEmpty() ? errorOutput : "The benchmark file could not be prepared.");
+        }
+
+        parseResult(output, errorOutput);
+    };
+
+    const double totalKBytes = double(fileSize) * 1024;
+
+    auto progress = [&] (QString output) {
+        if (!isRunning()) return;
+
+        emit benchmarkStatusUpdate(tr("Preparing... %1%").arg(qMin(100, int(parseProgress(output).ioKBytes * 100 / totalKBytes))));
+    };
+
+    runHelperTask(interface, [&] {
+        return interface->prepareBenchmarkFile(benchmarkFile, fileSize,
+                                               settings.getBenchmarkTestData() == Global::BenchmarkTestData::Zeros,
+                                               settings.getKeepBenchmarkFileState(),
+                                               testData.value("buffer_compress_percentage").toInt(),
+                                               testData.value("dedupe_percentage").toInt());
+    }, exitLoop, progress);
+}
+
+void Benchmark::prepareRawDevice(const QString &device)
+{
+    auto interface = helperInterface();
+    if (!interface) return;
+
+    handleDbusPendingCall(interface->prepareRawDevice(device));
+}
+
+void Benchmark::precondition(int passes)
+{
+    // SNIA PTS style: sequential fill of the whole file, then random 4K overwrites, each done N times
+    preconditionPass(Global::getRWSequentialWrite(), 128, passes, tr("Preconditioning: sequential fill %1%"));
 
     if (!isRunning()) return;
 
-    QEventLoop loop;
+    preconditionPass(Global::getRWRandomWrite(), 4, passes, tr("Preconditioning: random overwrite %1%"));
+}
 
-    auto exitLoop = [&] (bool success, QString output, QString errorOutput) {
-        loop.exit();
+void Benchmark::preconditionPass(const QString &rw, int blockSize, int passes, const QString &statusMessage)
+{
+    const AppSettings settings;
 
+    auto interface = helperInterface();
+    if (!interface) return;
+
+    emit benchmarkStatusUpdate(statusMessage.arg(0));
+
+    const double totalKBytes = double(settings.getFileSize()) * 1024 * passes * (m_extraDirs.size() + 1);
+
+    auto exitLoop = [&] (bool success, QString output, QString errorOutput) {
         if (!isRunning()) return;
 
         if (!success) {
             setRunning(false);
-            emit failed(!errorOutput.isEmpty() ? errorOutput : "The benchmark file could not be prepared.");
+            emit failed(!errorOutput.isEmpty() ? errorOutput : "Preconditioning failed.");
+            return;
         }
 
         parseResult(output, errorOutput);
     };
 
-    auto conn = QObject::connect(interface, &DevJonmagonKdiskmarkHelperInterface::taskFinished, exitLoop);
+    auto progress = [&] (QString output) {
+        if (!isRunning()) return;
+
+        emit benchmarkStatusUpdate(statusMessage.arg(qMin(100, int(parseProgress(output).ioKBytes * 100 / totalKBytes))));
+    };
 
-    loop.exec();
+    // Always done through fio, a runtime of 0 lets it cover the file the requested number of times
+    runHelperTask(interface, [&] {
+        return interface->startBenchmarkTest(0, settings.getFileSize(), 0,
+                                             settings.getBenchmarkTestData() == Global::BenchmarkTestData::Zeros,
+                                             settings.getCacheBypassState(),
+                                             settings.getContinuousGenerationState(),
+                                             blockSize, 32, 1, rw,
+                                             Global::getBenchmarkEngineName(Global::BenchmarkEngine::FIO),
+                                             withTestData({{"loops", QString::number(passes)}}));
+    }, exitLoop, progress);
+}
+
+void Benchmark::runHelperTask(DevJonmagonKdiskmarkHelperInterface *interface, const std::function<QDBusPendingCall()> &start,
+                              const std::function<void(bool, QString, QString)> &finished,
+                              const std::function<void(QString)> &progress)
+{
+    QEventLoop loop;
+    bool done = false;
+
+    // Subscribed before the call goes out: a task that fails at once finishes right behind its reply,
+    // sometimes while the reply is still being handled
+    auto conn = QObject::connect(interface, &DevJonmagonKdiskmarkHelperInterface::taskFinished,
+                                 [&] (bool success, QString output, QString errorOutput) {
+        done = true;
+        loop.exit();
+
+        finished(success, output, errorOutput);
+    });
+
+    QMetaObject::Connection progressConn;
+    if (progress) {
+        progressConn = QObject::connect(interface, &DevJonmagonKdiskmarkHelperInterface::taskProgress, progress);
+    }
+
+    QDBusPendingCall pcall = start();
+    handleDbusPendingCall(pcall);
+
+    // Nothing was started when the call failed, or when a kept benchmark file is reused as it is
+    if (isRunning() && !done && !QDBusPendingReply<QVariantMap>(pcall).value()["reused"].toBool()) {
+        loop.exec();
+    }
 
     QObject::disconnect(conn);
+    QObject::disconnect(progressConn);
 }
 
 void Benchmark::handleDbusPendingCall(QDBusPendingCall pcall)
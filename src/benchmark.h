@@ -6,12 +6,19 @@
 #include <QString>
 #include <QProgressBar>
 #include <QObject>
+#include <QVector>
+#include <QVariantMap>
 
+#include <functional>
 #include <memory>
 
 #include "appsettings.h"
+#include "latencyhistogram.h"
+#include "statistics.h"
 
 class QDBusPendingCall;
+class QJsonArray;
+class QJsonObject;
 class DevJonmagonKdiskmarkHelperInterface;
 
 class Benchmark : public QObject
@@ -28,17 +35,35 @@ public:
 
     void setDir(const QString &dir);
     QString getBenchmarkFile();
+    // Further directories benchmarked together with the main one
+    void setExtraDirs(const QStringList &dirs);
+    QStringList getExtraDirs();
+    // A block device under /dev is benchmarked in place, with read patterns only
+    bool isRawDevice();
 
     void setRunning(bool state);
     bool isRunning();
 
     void runBenchmark(QList<QPair<QPair<Global::BenchmarkTest, Global::BenchmarkIOReadWrite>, QVector<QProgressBar*>>> tests);
 
+    // Result of a single loop
+    struct Sample
+    {
+        float Bandwidth = 0;
+        float IOPS = 0;
+        float Latency = 0;
+    };
+
     struct PerformanceResult
     {
         float Bandwidth;
         float IOPS;
         float Latency;
+        LatencyHistogram Histogram;
+        QVector<Sample> Samples;
+        float SteadyStateTime = 0; // sec until steady state, negative when it was not reached, 0 if not measured
+        float SLOIOPS = 0; // highest IOPS within the latency bound, 0 if none or not measured
+        QVector<Sample> Targets; // per target in session order, only when several targets run together
 
         PerformanceResult operator+ (const PerformanceResult& rhs)
         {
@@ -50,6 +75,14 @@ public:
             Bandwidth += rhs.Bandwidth;
             IOPS += rhs.IOPS;
             Latency += rhs.Latency;
+            Histogram.merge(rhs.Histogram);
+            SteadyStateTime = mergeSteadyStateTime(SteadyStateTime, rhs.SteadyStateTime);
+            if (Targets.size() < rhs.Targets.size()) Targets.resize(rhs.Targets.size());
+            for (int i = 0; i < rhs.Targets.size(); i++) {
+                Targets[i].Bandwidth += rhs.Targets[i].Bandwidth;
+                Targets[i].IOPS += rhs.Targets[i].IOPS;
+                Targets[i].Latency += rhs.Targets[i].Latency;
+            }
             return *this;
         }
 
@@ -57,12 +90,30 @@ public:
         {
             if (rhs == 0) return *this;
 
-            return PerformanceResult { Bandwidth / rhs, IOPS / rhs, Latency / rhs };
+            PerformanceResult result = *this;
+            result.Bandwidth /= rhs;
+            result.IOPS /= rhs;
+            result.Latency /= rhs;
+            for (Sample &target : result.Targets) {
+                target.Bandwidth /= rhs;
+                target.IOPS /= rhs;
+                target.Latency /= rhs;
+            }
+            return result;
         }
 
         PerformanceResult operator* (const unsigned int rhs) const
         {
-            return PerformanceResult { Bandwidth * rhs, IOPS * rhs, Latency * rhs };
+            PerformanceResult result = *this;
+            result.Bandwidth *= rhs;
+            result.IOPS *= rhs;
+            result.Latency *= rhs;
+            for (Sample &target : result.Targets) {
+                target.Bandwidth *= rhs;
+                target.IOPS *= rhs;
+                target.Latency *= rhs;
+            }
+            return result;
         }
 
         void updateWithBetterValues(const PerformanceResult& result) {
@@ -70,37 +121,135 @@ public:
             IOPS = IOPS < result.IOPS ? result.IOPS : IOPS;
             if (Latency == 0) Latency = result.Latency;
             Latency = Latency > result.Latency ? result.Latency : Latency;
+            // Distributions are merged rather than picked, so percentiles cover every loop
+            Histogram.merge(result.Histogram);
+            SteadyStateTime = mergeSteadyStateTime(SteadyStateTime, result.SteadyStateTime);
+            if (Targets.size() < result.Targets.size()) Targets.resize(result.Targets.size());
+            for (int i = 0; i < result.Targets.size(); i++) {
+                Targets[i].Bandwidth = qMax(Targets[i].Bandwidth, result.Targets[i].Bandwidth);
+                Targets[i].IOPS = qMax(Targets[i].IOPS, result.Targets[i].IOPS);
+                if (Targets[i].Latency == 0 || Targets[i].Latency > result.Targets[i].Latency) Targets[i].Latency = result.Targets[i].Latency;
+            }
+        }
+
+        // The slowest job decides, and steady state counts as reached only if every job got there
+        static float mergeSteadyStateTime(float lhs, float rhs)
+        {
+            if (lhs == 0) return rhs;
+            if (rhs == 0) return lhs;
+
+            float time = qMax(qAbs(lhs), qAbs(rhs));
+            return lhs > 0 && rhs > 0 ? time : -time;
+        }
+
+        float percentile(double percent) const
+        {
+            return Histogram.percentile(percent) / 1000.f; // to usec
         }
     };
 
+    static Statistics::Summary summarize(const QVector<Sample> &samples, float Sample::*field);
+    // True once the primary metric's relative 95% CI is below the target, in percent
+    static bool isConverged(const QVector<Sample> &samples, int targetCI);
+
     struct ParsedJob
     {
         PerformanceResult read, write;
+        double ioKBytes = 0;
+        double runtime = 0; // msec
+        PerformanceResult sync { 0, 0, 0 }; // fsync and fdatasync calls, calls per second and latency only
     };
 
+    // A single measurement outside of the fixed tests, used by the tools
+    struct TestSpec
+    {
+        QString rw;
+        int blockSize; // KiB
+        int queueDepth;
+        int threads;
+        QVariantMap options;
+        int measuringTime = 0; // sec, 0 for the setting, negative for no limit
+        int readPercentage = -1; // of the mixed patterns, negative for the setting
+    };
+
+    // rate_iops value that holds a job of the pattern at iops in total, split over its threads on every target
+    // and, for the mixed patterns, over reads and writes by readPercentage
+    QString rateIOPS(const QString &rw, int readPercentage, int threads, double iops);
+
+    // Prepares the benchmark file the same way runBenchmark does, then runs body, which issues measure() calls
+    void runTool(const std::function<void()> &body);
+    // One loop of the spec with the current settings, returns false when the run was stopped or failed
+    bool measure(const TestSpec &spec, PerformanceResult &result, const QString &statusMessage);
+    // Same, keeping reads and writes apart
+    bool measure(const TestSpec &spec, ParsedJob &job, const QString &statusMessage);
+    // Hands a recorded trace to the helper, which replays it with the "trace" pattern.
+    // speed is in percent of the original rate, 0 for as fast as possible. Only valid inside runTool.
+    bool loadTrace(const QString &fileName, int speed, QVariantMap &summary);
+    // Populates a directory of small files next to the benchmark file, tested instead of it by specs with
+    // the "fileset" option and removed with it. fileSize is in KiB. Only valid inside runTool.
+    bool prepareFileSet(int files, int fileSize);
+
+    // One phase of the metadata test
+    struct MetadataPhase
+    {
+        QString operation; // create, stat, open, readdir, rename or unlink
+        bool cold = false; // the dentry and inode caches were dropped before it
+        double opsPerSecond = 0; // directory listings per second for readdir
+        double latency = 0; // mean, μs
+        LatencyHistogram histogram;
+    };
+
+    // Generates a tree of files next to the benchmark file and times the metadata calls on it,
+    // the tree is removed afterwards. Only valid inside runTool.
+    bool measureMetadata(int files, int filesPerDirectory, int threads, QVector<MetadataPhase> &phases);
+
 private:
     bool m_running;
     bool m_helperAuthorized;
     QString m_FIOVersion;
     QVector<QProgressBar*> m_progressBars;
     QString m_dir;
+    QStringList m_extraDirs;
 
     DevJonmagonKdiskmarkHelperInterface* helperInterface();
 
 private:
     void startTest(int blockSize, int queueDepth, int threads, const QString &rw, const QString &statusMessage);
+    // Bisects rate_iops below peakIOPS for the highest load whose latency percentile stays within the SLO bound
+    // of the settings, returns the IOPS achieved there, 0 when no probe met it
+    float searchSLOIOPS(TestSpec spec, double peakIOPS, const LatencyHistogram &peak, const QString &statusMessage);
     Benchmark::ParsedJob parseResult(const QString &output, const QString &errorOutput);
+    static Benchmark::ParsedJob parseProgress(const QString &output);
+    static QJsonArray jobsFromOutput(const QString &output);
+    static void addBins(LatencyHistogram &histogram, const QJsonObject &clat);
+    static void addJob(Benchmark::ParsedJob &parsedJob, const QJsonObject &job, int jobsCount, int targetsCount);
+    static int targetIndex(const QJsonObject &job);
+    static int targetsCount(const QJsonArray &jobs);
+    // Adds the fio options of the compressible test data from the settings, the other kinds need none
+    static QVariantMap withTestData(QVariantMap options);
     void sendResult(const Benchmark::PerformanceResult &result, const int index);
 
+    bool beginRun();
+    void endRun();
+
     void initSession();
     void prepareDirectory(const QString &benchmarkFile);
     void prepareFile(const QString &benchmarkFile, int fileSize);
+    void prepareRawDevice(const QString &device);
+    void precondition(int passes);
+    void preconditionPass(const QString &rw, int blockSize, int passes, const QString &statusMessage);
 
     void handleDbusPendingCall(QDBusPendingCall pcall);
+    // Sends the call that start makes and waits for the helper task it started, reporting its end to finished
+    // and its progress, if given, to progress
+    void runHelperTask(DevJonmagonKdiskmarkHelperInterface *interface, const std::function<QDBusPendingCall()> &start,
+                       const std::function<void(bool, QString, QString)> &finished,
+                       const std::function<void(QString)> &progress = {});
 
 signals:
     void benchmarkStatusUpdate(const QString &name);
     void resultReady(QProgressBar *progressBar, const Benchmark::PerformanceResult &result);
+    void liveSampleReady(const QString &series, unsigned int loop, double time, double bandwidth);
     void failed(const QString &error);
     void finished();
     void runningStateChanged(bool state);
@@ -109,4 +258,7 @@ signals:
     void createNoCowDirectoryResponse(bool create);
 };
 
+Q_DECLARE_METATYPE(LatencyHistogram)
+Q_DECLARE_METATYPE(Benchmark::Sample)
+
 #endif // BENCHMARK_H
@@ -0,0 +1,160 @@
+#include "chartwidget.h"
+
+#include <QPainter>
+#include <QPainterPath>
+
+#include "math.h"
+
+namespace {
+double niceStep(double range, int ticks)
+{
+    double step = range / ticks;
+    double magnitude = pow(10, floor(log10(step)));
+    double residual = step / magnitude;
+
+    if (residual > 5) return 10 * magnitude;
+    if (residual > 2) return 5 * magnitude;
+    if (residual > 1) return 2 * magnitude;
+    return magnitude;
+}
+}
+
+ChartWidget::ChartWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setBackgroundRole(QPalette::Base);
+    setAutoFillBackground(true);
+}
+
+void ChartWidget::setAxisTitles(const QString &x, const QString &y)
+{
+    m_xTitle = x;
+    m_yTitle = y;
+    update();
+}
+
+void ChartWidget::addPoint(const QString &name, double x, double y)
+{
+    series(name).points.append(QPointF(x, y));
+    update();
+}
+
+void ChartWidget::setSeries(const QString &name, const QVector<QPointF> &points)
+{
+    series(name).points = points;
+    update();
+}
+
+void ChartWidget::clear()
+{
+    m_series.clear();
+    update();
+}
+
+QSize ChartWidget::sizeHint() const
+{
+    return QSize(640, 360);
+}
+
+ChartWidget::Series &ChartWidget::series(const QString &name)
+{
+    for (Series &series : m_series) {
+        if (series.name == name) return series;
+    }
+
+    m_series.append(Series { name, {} });
+    return m_series.last();
+}
+
+void ChartWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    const QFontMetrics metrics = fontMetrics();
+    const QRect plot = rect().adjusted(metrics.height() * 2 + metrics.boundingRect("00000").width(), metrics.height(),
+                                       -metrics.height(), -metrics.height() * 3);
+
+    if (plot.width() <= 0 || plot.height() <= 0) return;
+
+    double maxX = 0, maxY = 0;
+    for (const Series &series : m_series) {
+        for (const QPointF &point : series.points) {
+            maxX = qMax(maxX, point.x());
+            maxY = qMax(maxY, point.y());
+        }
+    }
+
+    const double stepX = niceStep(maxX > 0 ? maxX : 1, 8);
+    const double stepY = niceStep(maxY > 0 ? maxY : 1, 5);
+    maxX = ceil((maxX > 0 ? maxX : 1) / stepX) * stepX;
+    maxY = ceil((maxY > 0 ? maxY : 1) / stepY) * stepY;
+
+    auto map = [&] (const QPointF &point) {
+        return QPointF(plot.left() + point.x() / maxX * plot.width(),
+                       plot.bottom() - point.y() / maxY * plot.height());
+    };
+
+    const QColor text = palette().color(QPalette::Text);
+    QColor grid = text;
+    grid.setAlpha(40);
+
+    for (double x = 0; x <= maxX + stepX / 2; x += stepX) {
+        QPointF pos = map(QPointF(x, 0));
+        painter.setPen(grid);
+        painter.drawLine(QPointF(pos.x(), plot.top()), pos);
+        painter.setPen(text);
+        painter.drawText(QRectF(pos.x() - 40, plot.bottom() + 2, 80, metrics.height()), Qt::AlignCenter, QString::number(x));
+    }
+
+    for (double y = 0; y <= maxY + stepY / 2; y += stepY) {
+        QPointF pos = map(QPointF(0, y));
+        painter.setPen(grid);
+        painter.drawLine(pos, QPointF(plot.right(), pos.y()));
+        painter.setPen(text);
+        painter.drawText(QRectF(0, pos.y() - metrics.height() / 2., plot.left() - 4, metrics.height()),
+                         Qt::AlignRight | Qt::AlignVCenter, QString::number(y));
+    }
+
+    painter.setPen(text);
+    painter.drawRect(plot);
+    painter.drawText(QRect(plot.left(), plot.bottom() + metrics.height() + 2, plot.width(), metrics.height()),
+                     Qt::AlignCenter, m_xTitle);
+
+    painter.save();
+    painter.translate(metrics.height() / 2., plot.center().y());
+    painter.rotate(-90);
+    painter.drawText(QRect(-plot.height() / 2, -metrics.height() / 2, plot.height(), metrics.height()),
+                     Qt::AlignCenter, m_yTitle);
+    painter.restore();
+
+    int legendX = plot.left();
+    const int legendY = plot.bottom() + metrics.height() * 2 + 4;
+
+    for (int i = 0; i < m_series.size(); i++) {
+        const Series &series = m_series.at(i);
+        const QColor color = QColor::fromHsv((i * 137) % 360, 200, 220);
+
+        if (series.points.size() > 1) {
+            QPainterPath path(map(series.points.first()));
+            for (int j = 1; j < series.points.size(); j++) {
+                path.lineTo(map(series.points.at(j)));
+            }
+            painter.setPen(QPen(color, 2));
+            painter.setBrush(Qt::NoBrush);
+            painter.drawPath(path);
+        }
+        else if (series.points.size() == 1) {
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(color);
+            painter.drawEllipse(map(series.points.first()), 3, 3);
+        }
+
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(color);
+        painter.drawRect(legendX, legendY + metrics.height() / 4, metrics.height() / 2, metrics.height() / 2);
+        painter.setPen(text);
+        painter.drawText(legendX + metrics.height(), legendY + metrics.ascent(), series.name);
+        legendX += metrics.height() * 2 + metrics.boundingRect(series.name).width();
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef CHARTWIDGET_H
+#define CHARTWIDGET_H
+
+#include <QWidget>
+#include <QVector>
+#include <QPointF>
+
+// Lightweight line chart, points are kept per series in insertion order
+class ChartWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ChartWidget(QWidget *parent = nullptr);
+
+    void setAxisTitles(const QString &x, const QString &y);
+    void addPoint(const QString &series, double x, double y);
+    void setSeries(const QString &series, const QVector<QPointF> &points);
+    void clear();
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    struct Series
+    {
+        QString name;
+        QVector<QPointF> points;
+    };
+
+    Series &series(const QString &name);
+
+    QVector<Series> m_series;
+    QString m_xTitle, m_yTitle;
+};
+
+#endif // CHARTWIDGET_H
@@ -0,0 +1,194 @@
+#include "commitlatencydialog.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QComboBox>
+#include <QFormLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QSpinBox>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "global.h"
+
+namespace {
+// Columns before the latency percentiles
+constexpr int FixedColumns = 4;
+}
+
+CommitLatencyDialog::CommitLatencyDialog(Benchmark *benchmark, QWidget *parent)
+    : ToolDialog(benchmark, parent)
+    , m_pattern(new QComboBox(this))
+    , m_blockSize(createBlockSizeCombo(4, 1024))
+    , m_committers(new QSpinBox(this))
+    , m_groupSize(new QSpinBox(this))
+    , m_table(new QTreeWidget(this))
+{
+    setWindowTitle(tr("Commit Latency"));
+
+    // A log is appended to, a data file is updated in place
+    m_pattern->addItem(tr("Sequential Write"), Global::getRWSequentialWrite());
+    m_pattern->addItem(tr("Random Write"), Global::getRWRandomWrite());
+
+    m_committers->setRange(1, 64);
+    m_committers->setToolTip(tr("Threads that commit independently, each waits for its own commit before the next"));
+
+    m_groupSize->setRange(2, 256);
+    m_groupSize->setValue(8);
+    m_groupSize->setToolTip(tr("Writes made durable together by one fdatasync in the group commit mode"));
+
+    QStringList headers { tr("Mode"), tr("Commits/s"), tr("MB/s"), tr("Commit μs") };
+    for (double percent : Global::getLatencyPercentiles()) {
+        headers << tr("p%1 μs").arg(percent);
+    }
+
+    m_table->setRootIsDecorated(false);
+    m_table->setHeaderLabels(headers);
+    m_table->headerItem()->setToolTip(FixedColumns - 1, tr("Mean time from the first write of a commit until it is durable"));
+    for (int i = FixedColumns; i < headers.size(); i++) {
+        m_table->headerItem()->setToolTip(i, tr("Latency of the durable step: the fdatasync or fsync call, or the O_DSYNC write itself"));
+    }
+
+    QFormLayout *formLayout = new QFormLayout;
+    formLayout->addRow(tr("Pattern:"), m_pattern);
+    formLayout->addRow(tr("Block size:"), m_blockSize);
+    formLayout->addRow(tr("Committers:"), m_committers);
+    formLayout->addRow(tr("Writes per group commit:"), m_groupSize);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(formLayout);
+    layout->addWidget(m_table, 1);
+    layout->addLayout(createButtonLayout());
+
+    m_inputs = { m_pattern, m_blockSize, m_committers, m_groupSize };
+
+    m_modes = modes();
+    updateResults();
+}
+
+double CommitLatencyDialog::commitsPerSecond(const Mode &mode)
+{
+    return mode.writesPerCommit > 0 ? mode.job.sync.IOPS : mode.job.write.IOPS;
+}
+
+double CommitLatencyDialog::commitLatency(const Mode &mode)
+{
+    // One committer waits for each of its writes and then the sync, so their means add up
+    return mode.writesPerCommit > 0 ? mode.writesPerCommit * mode.job.write.Latency + mode.job.sync.Latency
+                                    : mode.job.write.Latency;
+}
+
+const LatencyHistogram &CommitLatencyDialog::durableLatency(const Mode &mode)
+{
+    return mode.writesPerCommit > 0 ? mode.job.sync.Histogram : mode.job.write.Histogram;
+}
+
+QVector<CommitLatencyDialog::Mode> CommitLatencyDialog::modes() const
+{
+    const int groupSize = m_groupSize->value();
+
+    return {
+        { tr("Write + fdatasync"), {{ "fdatasync", "1" }}, 1 },
+        { tr("Write + fsync"), {{ "fsync", "1" }}, 1 },
+        { tr("O_DSYNC writes"), {{ "sync", "dsync" }}, 0 },
+        { tr("Group commit of %1").arg(groupSize), {{ "fdatasync", QString::number(groupSize) }}, groupSize }
+    };
+}
+
+void CommitLatencyDialog::updateResults()
+{
+    m_table->clear();
+
+    const QString none = QStringLiteral("–");
+
+    for (const Mode &mode : m_modes) {
+        QStringList columns { mode.name };
+
+        if (mode.measured) {
+            columns << QString::number(commitsPerSecond(mode), 'f', 0)
+                    << QString::number(mode.job.write.Bandwidth, 'f', 1)
+                    << QString::number(commitLatency(mode), 'f', 1);
+
+            for (double percent : Global::getLatencyPercentiles()) {
+                columns << QString::number(durableLatency(mode).percentile(percent) / 1000.0, 'f', 1);
+            }
+        }
+        else {
+            while (columns.size() < m_table->columnCount()) columns << none;
+        }
+
+        m_table->addTopLevelItem(new QTreeWidgetItem(columns));
+    }
+
+    for (int i = 0; i < m_table->columnCount(); i++) {
+        m_table->resizeColumnToContents(i);
+    }
+}
+
+bool CommitLatencyDialog::prepareRun()
+{
+    if (m_benchmark->isRawDevice()) {
+        QMessageBox::critical(this, tr("Not available"), tr("Commits write to the target, a raw device is benchmarked read-only."));
+        return false;
+    }
+
+    m_modes = modes();
+    updateResults();
+
+    return true;
+}
+
+bool CommitLatencyDialog::run()
+{
+    const QString rw = m_pattern->currentData().toString();
+    const int blockSize = m_blockSize->currentData().toInt();
+    const int committers = m_committers->value();
+
+    for (int i = 0; i < m_modes.size(); i++) {
+        Mode &mode = m_modes[i];
+
+        m_status->setText(tr("Running %1 of %2").arg(i + 1).arg(m_modes.size()));
+
+        // A commit is waited for before the next one starts, so every committer keeps one write in flight
+        Benchmark::TestSpec spec { rw, blockSize, 1, committers, mode.options };
+
+        if (!m_benchmark->measure(spec, mode.job, tr("%1 (%2/%3)").arg(mode.name).arg(i + 1).arg(m_modes.size()))) return false;
+
+        mode.measured = true;
+
+        updateResults();
+    }
+
+    return true;
+}
+
+bool CommitLatencyDialog::hasResults() const
+{
+    return !m_modes.isEmpty() && m_modes.first().measured;
+}
+
+void CommitLatencyDialog::copyResults()
+{
+    QString header = QStringLiteral("mode,commits_s,mb_s,commit_us");
+    for (double percent : Global::getLatencyPercentiles()) {
+        header += QStringLiteral(",durable_p%1_us").arg(percent);
+    }
+
+    QStringList lines { header };
+
+    for (const Mode &mode : m_modes) {
+        if (!mode.measured) continue;
+
+        QString line = QStringLiteral("\"%1\",%2,%3,%4").arg(mode.name).arg(commitsPerSecond(mode), 0, 'f', 3)
+                       .arg(mode.job.write.Bandwidth, 0, 'f', 3).arg(commitLatency(mode), 0, 'f', 3);
+
+        for (double percent : Global::getLatencyPercentiles()) {
+            line += QStringLiteral(",%1").arg(durableLatency(mode).percentile(percent) / 1000.0, 0, 'f', 3);
+        }
+
+        lines << line;
+    }
+
+    QApplication::clipboard()->setText(lines.join('\n'));
+}
@@ -0,0 +1,55 @@
+#ifndef COMMITLATENCYDIALOG_H
+#define COMMITLATENCYDIALOG_H
+
+#include <QVector>
+
+#include "tooldialog.h"
+
+class QComboBox;
+class QSpinBox;
+class QTreeWidget;
+
+// Durable writes the way databases commit: every write followed by fdatasync or fsync,
+// O_DSYNC writes, and a group commit of several writes per fdatasync, each reported as
+// commits per second and commit latency
+class CommitLatencyDialog : public ToolDialog
+{
+    Q_OBJECT
+
+public:
+    explicit CommitLatencyDialog(Benchmark *benchmark, QWidget *parent = nullptr);
+
+private:
+    struct Mode
+    {
+        QString name;
+        QVariantMap options;
+        int writesPerCommit; // 0 when the write itself is the commit
+        bool measured = false;
+        Benchmark::ParsedJob job {{ 0, 0, 0 }, { 0, 0, 0 }};
+    };
+
+    QVector<Mode> modes() const;
+
+    // Commits per second and the latency of the durable step, the sync call or the O_DSYNC write
+    static double commitsPerSecond(const Mode &mode);
+    static double commitLatency(const Mode &mode);
+    static const LatencyHistogram &durableLatency(const Mode &mode);
+
+    void updateResults();
+
+    bool prepareRun() override;
+    bool run() override;
+    bool hasResults() const override;
+    void copyResults() override;
+
+    QComboBox *m_pattern;
+    QComboBox *m_blockSize;
+    QSpinBox *m_committers;
+    QSpinBox *m_groupSize;
+    QTreeWidget *m_table;
+
+    QVector<Mode> m_modes;
+};
+
+#endif // COMMITLATENCYDIALOG_H
@@ -1,6 +1,7 @@
 #include "diskdriveinfo.h"
 
 #include <QString>
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
 #ifdef __FreeBSD__
@@ -22,7 +23,12 @@ QString DiskDriveInfo::getModelName(const QString &volume)
                                  .arg(getDeviceByVolume(volume)))
                        .canonicalFilePath());
 
-    QFile sysBlock(QStringLiteral("/sys/block/%1/device/model").arg(sysClass.baseName()));
+    // A whole disk has no parent block device
+    QString device = getDeviceByVolume(volume);
+    if (!QFileInfo::exists(QStringLiteral("/sys/block/%1").arg(device)))
+        device = sysClass.baseName();
+
+    QFile sysBlock(QStringLiteral("/sys/block/%1/device/model").arg(device));
 
     if (!sysBlock.open(QIODevice::ReadOnly | QIODevice::Text))
         return QString();
@@ -48,6 +54,28 @@ QString DiskDriveInfo::getModelName(const QString &volume)
     return model;
 }
 
+int DiskDriveInfo::getNumaNode(const QString &volume)
+{
+#if defined(__linux__)
+    // Block devices have no node of their own, it comes from the controller they hang off
+    QString path = QFileInfo(QStringLiteral("/sys/class/block/%1").arg(getDeviceByVolume(volume))).canonicalFilePath();
+    if (path.isEmpty())
+        return -1;
+
+    for (QDir dir(path); dir.path().startsWith(QLatin1String("/sys/devices/")); dir.cdUp()) {
+        QFile numaNode(dir.filePath(QStringLiteral("numa_node")));
+
+        if (numaNode.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            bool ok;
+            int node = numaNode.readAll().simplified().toInt(&ok);
+            return ok ? node : -1;
+        }
+    }
+#endif
+
+    return -1;
+}
+
 
 bool DiskDriveInfo::isEncrypted(const QString &volume)
 {
@@ -20,6 +20,7 @@ public:
 
   QString getDeviceByVolume(const QString &volume);
   QString getModelName(const QString &volume);
+  int getNumaNode(const QString &volume);
   bool isEncrypted(const QString &volume);
 };
 
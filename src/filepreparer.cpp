@@ -0,0 +1,268 @@
+#include "filepreparer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <vector>
+
+namespace {
+
+uint64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+}
+
+FilePreparer::FilePreparer(const Params &params) : m_params(params)
+{
+}
+
+FilePreparer::~FilePreparer()
+{
+    stop();
+}
+
+void FilePreparer::start(std::function<void()> finished)
+{
+    m_stop = false;
+    m_running = true;
+    m_error = 0;
+    m_bytesWritten = 0;
+    m_startNs = monotonicNs();
+    m_endNs = 0;
+
+    m_thread = std::thread([this, finished] {
+        run();
+
+        m_endNs = monotonicNs();
+        m_running = false;
+        finished();
+    });
+}
+
+void FilePreparer::stop()
+{
+    m_stop = true;
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool FilePreparer::isRunning() const
+{
+    return m_running;
+}
+
+const FilePreparer::Params &FilePreparer::params() const
+{
+    return m_params;
+}
+
+uint64_t FilePreparer::bytesWritten() const
+{
+    return m_bytesWritten.load(std::memory_order_relaxed);
+}
+
+uint64_t FilePreparer::elapsedNs() const
+{
+    const uint64_t end = m_endNs;
+    return (end ? end : monotonicNs()) - m_startNs;
+}
+
+int FilePreparer::error() const
+{
+    return m_error;
+}
+
+bool FilePreparer::isComplete() const
+{
+    return !m_running && m_error == 0 && bytesWritten() == m_params.fileSize * std::max(m_params.files, 1u);
+}
+
+void FilePreparer::fail(int error)
+{
+    int expected = 0;
+    m_error.compare_exchange_strong(expected, error);
+    m_stop = true;
+}
+
+void FilePreparer::run()
+{
+    if (m_params.files > 0) {
+        runFileSet();
+        return;
+    }
+
+    const uint64_t chunk = std::max(m_params.chunkSize, 4096u);
+
+    // Direct writes keep the fill out of the page cache; tmpfs and the like refuse O_DIRECT
+    int fd = open(m_params.fileName.c_str(), O_WRONLY | O_NOFOLLOW | O_DIRECT);
+    if (fd < 0 && errno == EINVAL) {
+        fd = open(m_params.fileName.c_str(), O_WRONLY | O_NOFOLLOW);
+    }
+    if (fd < 0) {
+        fail(errno);
+        return;
+    }
+
+    if (fallocate(fd, 0, 0, off_t(m_params.fileSize)) != 0) {
+        // Filesystems without fallocate support still get the file laid out by the writers below
+        if (errno != EOPNOTSUPP || ftruncate(fd, off_t(m_params.fileSize)) != 0) {
+            fail(errno);
+            close(fd);
+            return;
+        }
+    }
+
+    // Ranges are whole chunks, so every writer streams sequentially through its own part of the file
+    const uint64_t chunks = (m_params.fileSize + chunk - 1) / chunk;
+    const uint32_t writers = uint32_t(std::max<uint64_t>(1, std::min<uint64_t>(m_params.writers, chunks)));
+    const uint64_t chunksPerWriter = (chunks + writers - 1) / writers;
+
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < writers; i++) {
+        const uint64_t begin = std::min(m_params.fileSize, i * chunksPerWriter * chunk);
+        const uint64_t end = std::min(m_params.fileSize, (i + 1) * chunksPerWriter * chunk);
+        workers.emplace_back(&FilePreparer::fill, this, fd, i, begin, end);
+    }
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    if (m_error == 0 && !m_stop && fsync(fd) != 0) {
+        fail(errno);
+    }
+
+    close(fd);
+}
+
+void FilePreparer::runFileSet()
+{
+    const int directoryFd = open(m_params.fileName.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (directoryFd < 0) {
+        fail(errno);
+        return;
+    }
+
+    const uint32_t writers = std::max(1u, std::min(m_params.writers, m_params.files));
+
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < writers; i++) {
+        workers.emplace_back(&FilePreparer::fillFileSet, this, directoryFd, i);
+    }
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    // One writeback for the whole set instead of a sync per file
+    if (m_error == 0 && !m_stop && syncfs(directoryFd) != 0) {
+        fail(errno);
+    }
+
+    close(directoryFd);
+}
+
+void FilePreparer::fillFileSet(int directoryFd, unsigned index)
+{
+    const uint32_t writers = std::max(1u, std::min(m_params.writers, m_params.files));
+    const uint64_t chunk = std::min<uint64_t>(std::max(m_params.chunkSize, 4096u), std::max<uint64_t>(m_params.fileSize, 1));
+
+    void *buffer = nullptr;
+    if (posix_memalign(&buffer, 4096, chunk) != 0) {
+        fail(ENOMEM);
+        return;
+    }
+
+    memset(buffer, 0, chunk);
+    uint64_t randomState = std::random_device()() ^ (uint64_t(index + 1) << 32) ^ monotonicNs();
+
+    // Interleaved, so the writers create their files in the directory side by side
+    for (uint32_t file = index; file < m_params.files && !m_stop; file += writers) {
+        char name[32];
+        snprintf(name, sizeof(name), "f.%u", file);
+
+        const int fd = openat(directoryFd, name, O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            fail(errno);
+            break;
+        }
+
+        for (uint64_t offset = 0; offset < m_params.fileSize && !m_stop;) {
+            const size_t size = size_t(std::min(chunk, m_params.fileSize - offset));
+
+            if (!m_params.fillZeros) {
+                fillPattern(buffer, size, randomState, m_params.pattern);
+            }
+
+            ssize_t written = pwrite(fd, buffer, size, off_t(offset));
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                fail(errno);
+                break;
+            }
+            if (written == 0) {
+                fail(EIO);
+                break;
+            }
+
+            offset += uint64_t(written);
+            m_bytesWritten.fetch_add(uint64_t(written), std::memory_order_relaxed);
+        }
+
+        close(fd);
+    }
+
+    free(buffer);
+}
+
+void FilePreparer::fill(int fd, unsigned index, uint64_t begin, uint64_t end)
+{
+    const uint64_t chunk = std::max(m_params.chunkSize, 4096u);
+
+    void *buffer = nullptr;
+    if (posix_memalign(&buffer, 4096, chunk) != 0) {
+        fail(ENOMEM);
+        return;
+    }
+
+    memset(buffer, 0, chunk);
+    uint64_t randomState = std::random_device()() ^ (uint64_t(index + 1) << 32) ^ monotonicNs();
+
+    for (uint64_t offset = begin; offset < end && !m_stop;) {
+        const size_t size = size_t(std::min(chunk, end - offset));
+
+        // Fresh data for every chunk, otherwise deduplicating storage would store a single one
+        if (!m_params.fillZeros) {
+            fillPattern(buffer, size, randomState, m_params.pattern);
+        }
+
+        ssize_t written = pwrite(fd, buffer, size, off_t(offset));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            fail(errno);
+            break;
+        }
+        if (written == 0) {
+            fail(EIO);
+            break;
+        }
+
+        offset += uint64_t(written);
+        m_bytesWritten.fetch_add(uint64_t(written), std::memory_order_relaxed);
+    }
+
+    free(buffer);
+}
@@ -0,0 +1,69 @@
+#ifndef FILEPREPARER_H
+#define FILEPREPARER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "randomdata.h"
+
+// Lays out the benchmark file: the extents are reserved up front with fallocate,
+// then several writers fill disjoint ranges of it in parallel. Reserved but unwritten
+// extents read back as zeros without touching the media, so the fill is still needed.
+// It also populates sets of small files, spread over the writers a file at a time.
+class FilePreparer
+{
+public:
+    struct Params
+    {
+        std::string fileName;
+        uint64_t fileSize = 0; // bytes, of every file of a set
+        // Above 0, fileName is a directory that gets this many files named f.0, f.1 and so on,
+        // the names fio gives a set with filename_format=f.$filenum
+        uint32_t files = 0;
+        bool fillZeros = false;
+        DataPattern pattern; // of the data when not zeros
+        uint32_t writers = 4;
+        uint32_t chunkSize = 1 << 20; // bytes per write
+    };
+
+    explicit FilePreparer(const Params &params);
+    ~FilePreparer();
+
+    FilePreparer(const FilePreparer&) = delete;
+    FilePreparer& operator=(const FilePreparer&) = delete;
+
+    // Runs on a background thread, finished is called from that thread
+    void start(std::function<void()> finished);
+    // Joins the background thread, so it must not be called from finished, only by the owner
+    void stop();
+    bool isRunning() const;
+
+    const Params &params() const;
+    uint64_t bytesWritten() const;
+    uint64_t elapsedNs() const;
+    // errno of the first failure, 0 if none. Only valid once the finished callback has been called
+    int error() const;
+    // The whole file was written without errors
+    bool isComplete() const;
+
+private:
+    void run();
+    void runFileSet();
+    void fill(int fd, unsigned index, uint64_t begin, uint64_t end);
+    void fillFileSet(int directoryFd, unsigned index);
+    void fail(int error);
+
+    Params m_params;
+    std::atomic<bool> m_stop { false };
+    std::atomic<bool> m_running { false };
+    std::atomic<int> m_error { 0 };
+    std::atomic<uint64_t> m_bytesWritten { 0 };
+    std::atomic<uint64_t> m_startNs { 0 };
+    std::atomic<uint64_t> m_endNs { 0 };
+    std::thread m_thread;
+};
+
+#endif // FILEPREPARER_H
@@ -34,6 +34,36 @@ QString Global::getToolTipTemplate()
     return QObject::tr("<h1>%1 MB/s<br/>%2 GB/s<br/>%3 IOPS<br/>%4 μs</h1>");
 }
 
+QString Global::getPercentileToolTipTemplate()
+{
+    return QObject::tr("p%1: %2 μs");
+}
+
+QString Global::getSpreadToolTipTemplate()
+{
+    return QObject::tr("%1: %2 ± %3 (median %4, min %5, max %6, σ %7)");
+}
+
+QVector<double> Global::getLatencyPercentiles()
+{
+    return { 50, 90, 99, 99.9, 99.99 };
+}
+
+QString Global::formatBlockSize(int blockSize)
+{
+    return blockSize >= 1024 ? QStringLiteral("%1 %2").arg(blockSize / 1024).arg(QObject::tr("MiB"))
+                             : QStringLiteral("%1 %2").arg(blockSize).arg(QObject::tr("KiB"));
+}
+
+QString Global::formatDuration(qint64 msec)
+{
+    qint64 sec = (msec + 999) / 1000;
+
+    if (sec < 60) return QObject::tr("%1 s").arg(sec);
+    if (sec < 3600) return QObject::tr("%1 min %2 s").arg(sec / 60).arg(sec % 60);
+    return QObject::tr("%1 h %2 min").arg(sec / 3600).arg(sec % 3600 / 60);
+}
+
 QString Global::getComparisonLabelTemplate()
 {
     return QStringLiteral("<p align=\"center\">%1 [%2]</p>");
@@ -68,3 +98,16 @@ QString Global::getRWRandomMix()
 {
     return QStringLiteral("randrw");
 }
+
+QString Global::getBenchmarkEngineName(BenchmarkEngine engine)
+{
+    switch (engine)
+    {
+    case BenchmarkEngine::NativeIOUring:
+        return QStringLiteral("native");
+    case BenchmarkEngine::FIOServer:
+        return QStringLiteral("fio-server");
+    default:
+        return QStringLiteral("fio");
+    }
+}
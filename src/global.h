@@ -45,7 +45,8 @@ namespace Global
         Default,
         Peak,
         RealWorld,
-        Demo
+        Demo,
+        SteadyState
     };
     Q_ENUM_NS(PerformanceProfile)
 
@@ -62,7 +63,14 @@ namespace Global
 
     enum BenchmarkTestData {
         Random,
-        Zeros
+        Zeros,
+        Compressible // compression and dedupe percentages from the settings
+    };
+
+    enum BenchmarkEngine {
+        FIO,
+        NativeIOUring,
+        FIOServer
     };
 
     enum ComparisonUnit {
@@ -70,6 +78,7 @@ namespace Global
         GBPerSec,
         IOPS,
         Latency,
+        SLOIOPS, // highest IOPS whose latency percentile stays within the bound from the settings
     };
     Q_ENUM_NS(ComparisonUnit)
 
@@ -87,12 +96,16 @@ namespace Global
         qlonglong bytesOccupied;
         QString formatedSize;
         bool permanentInList = false;
+        bool rawDevice = false; // a block device read in place, bytesOccupied is unused
     };
 
     int getOutputColumnsCount();
     QString getBenchmarkButtonText(BenchmarkParams params, QString paramsLine = QStringLiteral());
     QString getBenchmarkButtonToolTip(BenchmarkParams params, bool extraField = false);
     QString getToolTipTemplate();
+    QString getPercentileToolTipTemplate();
+    QString getSpreadToolTipTemplate();
+    QVector<double> getLatencyPercentiles();
     QString getComparisonLabelTemplate();
     QString getRWSequentialRead();
     QString getRWSequentialWrite();
@@ -100,6 +113,9 @@ namespace Global
     QString getRWRandomRead();
     QString getRWRandomWrite();
     QString getRWRandomMix();
+    QString getBenchmarkEngineName(BenchmarkEngine engine);
+    QString formatBlockSize(int blockSize);
+    QString formatDuration(qint64 msec);
 }
 
 Q_DECLARE_METATYPE(Global::Storage)
@@ -0,0 +1,142 @@
+#include "heatmapwidget.h"
+
+#include <QPainter>
+
+#include "math.h"
+
+HeatmapWidget::HeatmapWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setBackgroundRole(QPalette::Base);
+    setAutoFillBackground(true);
+}
+
+void HeatmapWidget::setAxes(const QString &columnTitle, const QStringList &columns, const QString &rowTitle, const QStringList &rows)
+{
+    m_columnTitle = columnTitle;
+    m_columns = columns;
+    m_rowTitle = rowTitle;
+    m_rows = rows;
+    m_cells = QVector<Cell>(columns.size() * rows.size());
+    update();
+}
+
+HeatmapWidget::Cell &HeatmapWidget::cell(int row, int column)
+{
+    return m_cells[row * m_columns.size() + column];
+}
+
+void HeatmapWidget::setValue(int row, int column, double value, const QString &text)
+{
+    Cell &current = cell(row, column);
+    current.valid = true;
+    current.value = value;
+    current.text = text;
+    update();
+}
+
+void HeatmapWidget::setMarked(int row, int column, bool marked)
+{
+    cell(row, column).marked = marked;
+    update();
+}
+
+void HeatmapWidget::clearValues()
+{
+    m_cells = QVector<Cell>(m_cells.size());
+    update();
+}
+
+QSize HeatmapWidget::sizeHint() const
+{
+    return QSize(720, 420);
+}
+
+void HeatmapWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+
+    const QColor text = palette().color(QPalette::Text);
+    const QFontMetrics metrics = fontMetrics();
+
+    if (m_columns.isEmpty() || m_rows.isEmpty()) return;
+
+    int labelWidth = 0;
+    for (const QString &row : m_rows) {
+        labelWidth = qMax(labelWidth, metrics.boundingRect(row).width());
+    }
+
+    const QRect plot = rect().adjusted(metrics.height() * 2 + labelWidth, metrics.height() / 2,
+                                       -metrics.height() / 2, -metrics.height() * 3);
+    if (plot.width() <= 0 || plot.height() <= 0) return;
+
+    const double cellWidth = double(plot.width()) / m_columns.size();
+    const double cellHeight = double(plot.height()) / m_rows.size();
+
+    // Values span orders of magnitude across a sweep, so the color follows the logarithm
+    double minValue = 0, maxValue = 0;
+    for (const Cell &cell : m_cells) {
+        if (!cell.valid || cell.value <= 0) continue;
+        minValue = minValue == 0 ? cell.value : qMin(minValue, cell.value);
+        maxValue = qMax(maxValue, cell.value);
+    }
+
+    const double range = maxValue > minValue ? log(maxValue / minValue) : 0;
+
+    for (int row = 0; row < m_rows.size(); row++) {
+        for (int column = 0; column < m_columns.size(); column++) {
+            const Cell &current = m_cells.at(row * m_columns.size() + column);
+            const QRectF area(plot.left() + column * cellWidth, plot.top() + row * cellHeight, cellWidth, cellHeight);
+
+            if (current.valid) {
+                double position = range > 0 && current.value > 0 ? log(current.value / minValue) / range : 1;
+                // From blue for the lowest value to red for the highest
+                painter.fillRect(area, QColor::fromHsv(int(240 * (1 - position)), 160, 230));
+                painter.setPen(Qt::black);
+                painter.drawText(area, Qt::AlignCenter, current.text);
+            }
+
+            if (current.marked) {
+                painter.setPen(QPen(text, 3));
+                painter.setBrush(Qt::NoBrush);
+                painter.drawRect(area.adjusted(1.5, 1.5, -1.5, -1.5));
+            }
+        }
+    }
+
+    QColor grid = text;
+    grid.setAlpha(40);
+    painter.setPen(grid);
+
+    for (int column = 1; column < m_columns.size(); column++) {
+        painter.drawLine(QPointF(plot.left() + column * cellWidth, plot.top()), QPointF(plot.left() + column * cellWidth, plot.bottom()));
+    }
+
+    for (int row = 1; row < m_rows.size(); row++) {
+        painter.drawLine(QPointF(plot.left(), plot.top() + row * cellHeight), QPointF(plot.right(), plot.top() + row * cellHeight));
+    }
+
+    painter.setPen(text);
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(plot);
+
+    for (int column = 0; column < m_columns.size(); column++) {
+        painter.drawText(QRectF(plot.left() + column * cellWidth, plot.bottom() + 2, cellWidth, metrics.height()),
+                         Qt::AlignCenter, m_columns.at(column));
+    }
+
+    for (int row = 0; row < m_rows.size(); row++) {
+        painter.drawText(QRectF(0, plot.top() + row * cellHeight, plot.left() - 4, cellHeight),
+                         Qt::AlignRight | Qt::AlignVCenter, m_rows.at(row));
+    }
+
+    painter.drawText(QRect(plot.left(), plot.bottom() + metrics.height() + 2, plot.width(), metrics.height()),
+                     Qt::AlignCenter, m_columnTitle);
+
+    painter.save();
+    painter.translate(metrics.height() / 2., plot.center().y());
+    painter.rotate(-90);
+    painter.drawText(QRect(-plot.height() / 2, -metrics.height() / 2, plot.height(), metrics.height()),
+                     Qt::AlignCenter, m_rowTitle);
+    painter.restore();
+}
@@ -0,0 +1,42 @@
+#ifndef HEATMAPWIDGET_H
+#define HEATMAPWIDGET_H
+
+#include <QWidget>
+#include <QStringList>
+#include <QVector>
+
+// Grid of values colored on a logarithmic scale, cells without a value stay empty
+class HeatmapWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit HeatmapWidget(QWidget *parent = nullptr);
+
+    void setAxes(const QString &columnTitle, const QStringList &columns, const QString &rowTitle, const QStringList &rows);
+    void setValue(int row, int column, double value, const QString &text);
+    void setMarked(int row, int column, bool marked);
+    void clearValues();
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    struct Cell
+    {
+        bool valid = false;
+        bool marked = false;
+        double value = 0;
+        QString text;
+    };
+
+    Cell &cell(int row, int column);
+
+    QString m_columnTitle, m_rowTitle;
+    QStringList m_columns, m_rows;
+    QVector<Cell> m_cells;
+};
+
+#endif // HEATMAPWIDGET_H
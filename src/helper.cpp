@@ -1,19 +1,354 @@
 #include "helper.h"
+#include "tracereplay.h"
 
 #include <QCoreApplication>
 #include <QtDBus>
 #include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QRegularExpression>
 #include <PolkitQt1/Authority>
 #include <PolkitQt1/Subject>
 
 #include <signal.h>
+#include <sched.h>
 
 #include <sys/ioctl.h>
+#include <sys/stat.h>
 #include <sys/statfs.h>
 #include <linux/fs.h>
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <cstring>
+
+namespace {
+
+// Extra fio job options from the GUI. The helper runs as root, so only known keys with sane values pass.
+bool appendJobOptions(const QVariantMap &options, QStringList &jobOptions, QString &error)
+{
+    static const QMap<QString, QRegularExpression> allowed = {
+        { QStringLiteral("time_based"), QRegularExpression(QStringLiteral("^[01]$")) },
+        { QStringLiteral("loops"), QRegularExpression(QStringLiteral("^[1-9]\\d?$")) },
+        { QStringLiteral("steadystate"), QRegularExpression(QStringLiteral("^(iops|bw)(_slope)?:\\d+(\\.\\d+)?%?$")) },
+        { QStringLiteral("steadystate_duration"), QRegularExpression(QStringLiteral("^\\d+$")) },
+        { QStringLiteral("steadystate_ramp_time"), QRegularExpression(QStringLiteral("^\\d+$")) },
+        { QStringLiteral("cpus_allowed"), QRegularExpression(QStringLiteral("^\\d+(-\\d+)?(,\\d+(-\\d+)?)*$")) },
+        { QStringLiteral("cpus_allowed_policy"), QRegularExpression(QStringLiteral("^(shared|split)$")) },
+        { QStringLiteral("numa_cpu_nodes"), QRegularExpression(QStringLiteral("^\\d+(-\\d+)?(,\\d+(-\\d+)?)*$")) },
+        { QStringLiteral("numa_mem_policy"), QRegularExpression(QStringLiteral("^(default|local|(prefer|bind|interleave):\\d+(-\\d+)?(,\\d+(-\\d+)?)*)$")) },
+        { QStringLiteral("bssplit"), QRegularExpression(QStringLiteral("^\\d+[kKmM]?/\\d{1,3}(:\\d+[kKmM]?/\\d{1,3})*$")) },
+        { QStringLiteral("rate"), QRegularExpression(QStringLiteral("^\\d+[kKmMgG]?(,\\d+[kKmMgG]?)?$")) },
+        { QStringLiteral("rate_iops"), QRegularExpression(QStringLiteral("^\\d+(,\\d+)?$")) },
+        { QStringLiteral("rate_process"), QRegularExpression(QStringLiteral("^(linear|poisson)$")) },
+        { QStringLiteral("random_distribution"), QRegularExpression(QStringLiteral("^(random|(zipf|pareto|normal):\\d+(\\.\\d+)?)$")) },
+        { QStringLiteral("norandommap"), QRegularExpression(QStringLiteral("^[01]$")) },
+        { QStringLiteral("fsync"), QRegularExpression(QStringLiteral("^\\d{1,6}$")) },
+        { QStringLiteral("fdatasync"), QRegularExpression(QStringLiteral("^\\d{1,6}$")) },
+        { QStringLiteral("openfiles"), QRegularExpression(QStringLiteral("^[1-9]\\d{0,4}$")) },
+        { QStringLiteral("buffer_compress_percentage"), QRegularExpression(QStringLiteral("^(\\d{1,2}|100)$")) },
+        { QStringLiteral("dedupe_percentage"), QRegularExpression(QStringLiteral("^(\\d{1,2}|100)$")) },
+        { QStringLiteral("file_service_type"), QRegularExpression(QStringLiteral("^(random|roundrobin|sequential)(:\\d{1,6})?$")) },
+        { QStringLiteral("sync"), QRegularExpression(QStringLiteral("^(0|1|none|sync|dsync)$")) }
+    };
+
+    for (auto it = options.constBegin(); it != options.constEnd(); ++it) {
+        const QString value = it.value().toString();
+        auto rule = allowed.constFind(it.key());
+
+        if (rule == allowed.constEnd() || !rule->match(value).hasMatch()) {
+            error = QStringLiteral("The job option %1=%2 is not allowed.").arg(it.key(), value);
+            return false;
+        }
+
+        jobOptions << QStringLiteral("%1=%2").arg(it.key(), value);
+    }
+
+    return true;
+}
+
+// fio style CPU list, e.g. 0-3,8,10-11
+std::vector<int> parseCpuList(const QString &list)
+{
+    std::vector<int> cpus;
+
+    for (const QString &range : list.split(QLatin1Char(','))) {
+        const QStringList bounds = range.split(QLatin1Char('-'));
+        const int first = bounds.first().toInt();
+        const int last = bounds.last().toInt();
+
+        for (int cpu = first; cpu <= last && cpus.size() < CPU_SETSIZE; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+
+    return cpus;
+}
+
+// CPUs of the given NUMA nodes, as listed in sysfs
+std::vector<int> numaNodeCpus(const QString &nodes)
+{
+    std::vector<int> cpus;
+
+    for (int node : parseCpuList(nodes)) {
+        QFile cpuList(QStringLiteral("/sys/devices/system/node/node%1/cpulist").arg(node));
+        if (!cpuList.open(QIODevice::ReadOnly | QIODevice::Text)) continue;
+
+        std::vector<int> nodeCpus = parseCpuList(QString::fromLatin1(cpuList.readAll().simplified()));
+        cpus.insert(cpus.end(), nodeCpus.begin(), nodeCpus.end());
+    }
+
+    return cpus;
+}
+
+// Mirrors the subset of the fio JSON output that the GUI parses
+QJsonObject nativeDirectionToJson(const UringEngine::DirectionStats &stats, quint64 runtimeNs)
+{
+    const double runtime = runtimeNs / 1e9;
+
+    // Same layout as fio json+ bins: bucket midpoint in ns mapped to the sample count
+    QJsonObject bins;
+    for (unsigned i = 0; i < LatencyHistogram::BucketCount; i++) {
+        if (stats.clat.bucket(i) > 0) {
+            bins.insert(QString::number(LatencyHistogram::bucketValue(i)), qint64(stats.clat.bucket(i)));
+        }
+    }
+
+    return {
+        {"io_bytes", qint64(stats.bytes)},
+        {"io_kbytes", qint64(stats.bytes / 1024)},
+        {"bw", qint64(runtime > 0 ? stats.bytes / 1024 / runtime : 0)},
+        {"iops", runtime > 0 ? stats.ios / runtime : 0.},
+        {"runtime", qint64(runtimeNs / 1000000)},
+        {"total_ios", qint64(stats.ios)},
+        {"clat_ns", QJsonObject {
+            {"min", qint64(stats.clatMinNs)},
+            {"max", qint64(stats.clatMaxNs)},
+            {"mean", stats.ios > 0 ? double(stats.clatSumNs) / stats.ios : 0.},
+            {"bins", bins}
+        }}
+    };
+}
+
+// Cuts complete top-level JSON documents off the front of the buffer. With a status interval
+// fio prints one document per interval, and in client mode connection details come first.
+QList<QByteArray> takeJsonDocuments(QByteArray &buffer)
+{
+    QList<QByteArray> documents;
+    int depth = 0, start = -1, consumed = 0;
+    bool inString = false, escaped = false;
+
+    for (int i = 0; i < buffer.size(); i++) {
+        const char c = buffer.at(i);
+
+        if (inString) {
+            if (escaped) escaped = false;
+            else if (c == '\\') escaped = true;
+            else if (c == '"') inString = false;
+            continue;
+        }
+
+        if (c == '"' && depth > 0) {
+            inString = true;
+        }
+        else if (c == '{') {
+            if (depth++ == 0) start = i;
+        }
+        else if (c == '}' && depth > 0 && --depth == 0) {
+            documents << buffer.mid(start, i - start + 1);
+            consumed = i + 1;
+        }
+        else if (depth == 0) {
+            consumed = i + 1;
+        }
+    }
+
+    buffer.remove(0, consumed);
+
+    return documents;
+}
+
+QString nativeReport(const std::vector<UringEngine::JobStats> &results, QStringList *errors = nullptr)
+{
+    QJsonArray jobs;
+
+    for (const UringEngine::JobStats &stats : results) {
+        jobs.append(QJsonObject {
+            {"jobname", "native"},
+            {"error", stats.error},
+            {"read", nativeDirectionToJson(stats.read, stats.runtimeNs)},
+            {"write", nativeDirectionToJson(stats.write, stats.runtimeNs)}
+        });
+
+        if (errors && stats.error != 0) {
+            *errors << QString::fromLocal8Bit(strerror(stats.error));
+        }
+    }
+
+    return QString::fromUtf8(QJsonDocument(QJsonObject {{"jobs", jobs}}).toJson(QJsonDocument::Compact));
+}
+
+QString metadataReport(const std::vector<MetadataEngine::PhaseStats> &results)
+{
+    QJsonArray phases;
+
+    for (const MetadataEngine::PhaseStats &stats : results) {
+        const double runtime = stats.runtimeNs / 1e9;
+
+        // Same bins layout as nativeDirectionToJson, so the GUI reads them the usual way
+        QJsonObject bins;
+        for (unsigned i = 0; i < LatencyHistogram::BucketCount; i++) {
+            if (stats.lat.bucket(i) > 0) {
+                bins.insert(QString::number(LatencyHistogram::bucketValue(i)), qint64(stats.lat.bucket(i)));
+            }
+        }
+
+        phases.append(QJsonObject {
+            {"operation", MetadataEngine::operationName(stats.operation)},
+            {"cold", stats.cold},
+            {"ops", qint64(stats.ops)},
+            {"ops_per_sec", runtime > 0 ? stats.ops / runtime : 0.},
+            {"runtime", qint64(stats.runtimeNs / 1000000)},
+            {"lat_ns", QJsonObject {
+                {"min", qint64(stats.latMinNs)},
+                {"max", qint64(stats.latMaxNs)},
+                {"mean", stats.ops > 0 ? double(stats.latSumNs) / stats.ops : 0.},
+                {"bins", bins}
+            }}
+        });
+    }
+
+    return QString::fromUtf8(QJsonDocument(QJsonObject {{"phases", phases}}).toJson(QJsonDocument::Compact));
+}
+
+QString metadataProgress(const MetadataEngine &engine)
+{
+    const unsigned phase = engine.currentPhase();
+
+    return QString::fromUtf8(QJsonDocument(QJsonObject {
+        {"phase", int(phase)},
+        {"phases", int(MetadataEngine::phaseCount())},
+        {"ops", qint64(engine.currentOps())},
+        {"total", qint64(engine.phaseOps(phase))}
+    }).toJson(QJsonDocument::Compact));
+}
+
+// Same layout as the fio output of a single write job, so the GUI parses the progress the usual way
+QString preparationReport(quint64 bytes, quint64 elapsedNs, int error)
+{
+    const double runtime = elapsedNs / 1e9;
+
+    QJsonObject write {
+        {"io_bytes", qint64(bytes)},
+        {"io_kbytes", qint64(bytes / 1024)},
+        {"bw", qint64(runtime > 0 ? bytes / 1024 / runtime : 0)},
+        {"runtime", qint64(elapsedNs / 1000000)}
+    };
+
+    QJsonObject job {
+        {"jobname", "prepare"},
+        {"error", error},
+        {"write", write}
+    };
+
+    return QString::fromUtf8(QJsonDocument(QJsonObject {{"jobs", QJsonArray {job}}}).toJson(QJsonDocument::Compact));
+}
+
+QString preparationReport(const FilePreparer &preparer)
+{
+    return preparationReport(preparer.bytesWritten(), preparer.elapsedNs(), preparer.isRunning() ? 0 : preparer.error());
+}
+
+// The kept benchmark file and its metadata. Benchmark tests overwrite the whole file,
+// so the metadata lives next to it instead of in a header inside it
+const QString cachedFileName = QStringLiteral("kdiskmark-cache.dat");
+const QString cachedMetadataName = QStringLiteral("kdiskmark-cache.json");
+
+QString cachedMetadataPath(const QString &fileName)
+{
+    return QFileInfo(fileName).absoluteDir().filePath(cachedMetadataName);
+}
+
+// Both files live in a directory of the user, so links are never followed
+int openNoFollow(const QString &fileName, int flags)
+{
+    return open(QFile::encodeName(fileName).constData(), flags | O_NOFOLLOW | O_CLOEXEC, 0600);
+}
+
+// The compressible test data comes with the job options, the native engine and the kept files need it too
+DataPattern dataPattern(const QVariantMap &options)
+{
+    DataPattern pattern;
+    pattern.compressPercentage = options.value(QStringLiteral("buffer_compress_percentage")).toUInt();
+    pattern.dedupePercentage = options.value(QStringLiteral("dedupe_percentage")).toUInt();
+    return pattern;
+}
+
+QJsonObject cachedFileStamp(int fd, bool fillZeros, const DataPattern &pattern)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        return {};
+    }
+
+    // Any write to the file since the stamp was taken changes the mtime
+    return {
+        {"version", 2},
+        {"size", qint64(st.st_size)},
+        {"zeros", fillZeros},
+        {"compress", int(pattern.compressPercentage)},
+        {"dedupe", int(pattern.dedupePercentage)},
+        {"mtime_sec", qint64(st.st_mtim.tv_sec)},
+        {"mtime_nsec", qint64(st.st_mtim.tv_nsec)}
+    };
+}
+
+bool isCachedFileValid(const QString &fileName, int fd, quint64 fileSize, bool fillZeros, const DataPattern &pattern)
+{
+    const int metadataFd = openNoFollow(cachedMetadataPath(fileName), O_RDONLY);
+    if (metadataFd < 0) {
+        return false;
+    }
+
+    QFile metadata;
+    if (!metadata.open(metadataFd, QIODevice::ReadOnly, QFileDevice::AutoCloseHandle)) {
+        close(metadataFd);
+        return false;
+    }
+
+    const QJsonObject stamp = cachedFileStamp(fd, fillZeros, pattern);
+
+    // Written by writeCachedFileStamp in the same compact form, so the bytes have to match exactly
+    return !stamp.isEmpty() && quint64(stamp["size"].toDouble()) == fileSize
+            && metadata.read(4096) == QJsonDocument(stamp).toJson(QJsonDocument::Compact);
+}
+
+bool writeCachedFileStamp(const QString &fileName, int fd, bool fillZeros, const DataPattern &pattern)
+{
+    const QJsonObject stamp = cachedFileStamp(fd, fillZeros, pattern);
+    if (stamp.isEmpty()) {
+        return false;
+    }
+
+    const int metadataFd = openNoFollow(cachedMetadataPath(fileName), O_WRONLY | O_CREAT | O_TRUNC);
+    if (metadataFd < 0) {
+        return false;
+    }
+
+    QFile metadata;
+    if (!metadata.open(metadataFd, QIODevice::WriteOnly, QFileDevice::AutoCloseHandle)) {
+        close(metadataFd);
+        return false;
+    }
+
+    return metadata.write(QJsonDocument(stamp).toJson(QJsonDocument::Compact)) > 0;
+}
+
+}
+
 HelperAdaptor::HelperAdaptor(Helper *parent) :
     QDBusAbstractAdaptor(parent)
 {
@@ -30,17 +365,39 @@ QVariantMap HelperAdaptor::endSession()
     return m_parentHelper->endSession();
 }
 
-QVariantMap HelperAdaptor::prepareBenchmarkFile(const QString &benchmarkFile, int fileSize, bool fillZeros)
+QVariantMap HelperAdaptor::prepareBenchmarkFile(const QString &benchmarkFile, int fileSize, bool fillZeros, bool keepFile,
+                                                int compressPercentage, int dedupePercentage)
+{
+    return m_parentHelper->prepareBenchmarkFile(benchmarkFile, fileSize, fillZeros, keepFile, compressPercentage, dedupePercentage);
+}
+
+QVariantMap HelperAdaptor::prepareRawDevice(const QString &device)
+{
+    return m_parentHelper->prepareRawDevice(device);
+}
+
+QVariantMap HelperAdaptor::prepareFileSet(int files, int fileSize, bool fillZeros, int compressPercentage, int dedupePercentage)
 {
-    return m_parentHelper->prepareBenchmarkFile(benchmarkFile, fileSize, fillZeros);
+    return m_parentHelper->prepareFileSet(files, fileSize, fillZeros, compressPercentage, dedupePercentage);
+}
+
+QVariantMap HelperAdaptor::loadTrace(const QDBusUnixFileDescriptor &trace, int speed)
+{
+    return m_parentHelper->loadTrace(trace, speed);
 }
 
 QVariantMap HelperAdaptor::startBenchmarkTest(int measuringTime, int fileSize, int randomReadPercentage, bool fillZeros, bool cacheBypass, bool continuousGeneration,
-                                              int blockSize, int queueDepth, int threads, const QString &rw)
+                                              int blockSize, int queueDepth, int threads, const QString &rw, const QString &engine,
+                                              const QVariantMap &options)
 {
     return m_parentHelper->startBenchmarkTest(
       measuringTime, fileSize, randomReadPercentage, fillZeros, cacheBypass,
-      continuousGeneration, blockSize, queueDepth, threads, rw);
+      continuousGeneration, blockSize, queueDepth, threads, rw, engine, options);
+}
+
+QVariantMap HelperAdaptor::startMetadataTest(int files, int filesPerDirectory, int threads)
+{
+    return m_parentHelper->startMetadataTest(files, filesPerDirectory, threads);
 }
 
 QVariantMap HelperAdaptor::flushPageCache()
@@ -88,6 +445,15 @@ Helper::Helper() : m_helperAdaptor(new HelperAdaptor(this))
     });
 
     QObject::connect(this, &Helper::taskFinished, m_helperAdaptor, &HelperAdaptor::taskFinished);
+    QObject::connect(this, &Helper::taskProgress, m_helperAdaptor, &HelperAdaptor::taskProgress);
+
+    m_progressTimer = new QTimer(this);
+    m_progressTimer->setInterval(1000);
+    connect(m_progressTimer, &QTimer::timeout, this, [this] {
+        if (m_preparer && m_preparer->isRunning()) emit taskProgress(preparationReport(*m_preparer));
+        else if (m_metadataEngine && m_metadataEngine->isRunning()) emit taskProgress(metadataProgress(*m_metadataEngine));
+        else if (m_engine && m_engine->isRunning()) emit taskProgress(nativeReport(m_engine->progress()));
+    });
 }
 
 QVariantMap Helper::initSession()
@@ -104,35 +470,42 @@ QVariantMap Helper::initSession()
         return {{"success", false}, {"error", "There are already registered DBus connection."}};
     }
 
+    if (isActionAuthorized(QStringLiteral("dev.jonmagon.kdiskmark.helper.init"))) {
+        // track who called into us so we can close when all callers have gone away
+        m_serviceWatcher->addWatchedService(message().service());
+        return {{"success", true}};
+    }
+    else {
+        sendErrorReply(QDBusError::AccessDenied);
+        if (m_serviceWatcher->watchedServices().isEmpty())
+            qApp->quit();
+        return {};
+    }
+}
+
+bool Helper::isActionAuthorized(const QString &action)
+{
     PolkitQt1::SystemBusNameSubject subject(message().service());
     PolkitQt1::Authority *authority = PolkitQt1::Authority::instance();
 
     PolkitQt1::Authority::Result result = PolkitQt1::Authority::No;
     QEventLoop e;
-    connect(authority, &PolkitQt1::Authority::checkAuthorizationFinished, &e, [&e, &result](PolkitQt1::Authority::Result _result) {
+    auto conn = connect(authority, &PolkitQt1::Authority::checkAuthorizationFinished, &e, [&e, &result](PolkitQt1::Authority::Result _result) {
         result = _result;
         e.quit();
     });
 
-    authority->checkAuthorization(QStringLiteral("dev.jonmagon.kdiskmark.helper.init"), subject, PolkitQt1::Authority::AllowUserInteraction);
+    authority->checkAuthorization(action, subject, PolkitQt1::Authority::AllowUserInteraction);
     e.exec();
 
+    disconnect(conn);
+
     if (authority->hasError()) {
         qDebug() << "Encountered error while checking authorization, error code: " << authority->lastError() << authority->errorDetails();
         authority->clearError();
     }
 
-    switch (result) {
-    case PolkitQt1::Authority::Yes:
-        // track who called into us so we can close when all callers have gone away
-        m_serviceWatcher->addWatchedService(message().service());
-        return {{"success", true}};
-    default:
-        sendErrorReply(QDBusError::AccessDenied);
-        if (m_serviceWatcher->watchedServices().isEmpty())
-            qApp->quit();
-        return {};
-    }
+    return result == PolkitQt1::Authority::Yes;
 }
 
 QVariantMap Helper::endSession()
@@ -141,6 +514,8 @@ QVariantMap Helper::endSession()
         return {};
     }
 
+    stopFioServer();
+
     qApp->exit();
 
     return {};
@@ -166,90 +541,657 @@ bool Helper::testFilePath(const QString &benchmarkPath)
     return true;
 }
 
-QVariantMap Helper::prepareBenchmarkFile(const QString &benchmarkPath, int fileSize, bool fillZeros)
+bool Helper::hasTargets() const
+{
+    if (!m_rawDevice.isEmpty()) {
+        return QFile::exists(m_rawDevice);
+    }
+
+    if (m_benchmarkFiles.empty()) {
+        return false;
+    }
+
+    for (const auto &benchmarkFile : m_benchmarkFiles) {
+        if (!QFile(benchmarkFile->fileName()).exists()) return false;
+    }
+
+    return true;
+}
+
+QVariantMap Helper::prepareBenchmarkFile(const QString &benchmarkPath, int fileSize, bool fillZeros, bool keepFile,
+                                         int compressPercentage, int dedupePercentage)
 {
     if (!isCallerAuthorized()) {
         return {};
     }
 
-    // If benchmarking has been done, but removeBenchmarkFile has not been called,
-    // and benchmarking on a new file is called, then reject the request. The *previous* file must be removed first.
-    if (!m_benchmarkFile.fileName().isNull()) {
+    // Every call adds a target to the session. If benchmarking has been done, but removeBenchmarkFile has not been called,
+    // and benchmarking on the same directory is called, then reject the request. The *previous* file must be removed first.
+    if (!m_rawDevice.isEmpty()) {
         return {{"success", false}, {"error", "A new benchmark session should be started."}};
     }
 
+    for (const auto &benchmarkFile : m_benchmarkFiles) {
+        if (QFileInfo(benchmarkFile->fileName()).absolutePath() == QFileInfo(benchmarkPath).absoluteFilePath()) {
+            return {{"success", false}, {"error", "A new benchmark session should be started."}};
+        }
+    }
+
     if (!testFilePath(benchmarkPath)) {
         return {{"success", false}, {"error", "The path to the file is incorrect."}};
     }
 
-    m_benchmarkFile.setFileTemplate(QStringLiteral("%1/%2").arg(benchmarkPath).arg("kdiskmark-XXXXXX.tmp"));
+    if (compressPercentage < 0 || compressPercentage > 100 || dedupePercentage < 0 || dedupePercentage > 100) {
+        return {{"success", false}, {"error", "Invalid test data parameters."}};
+    }
+
+    DataPattern pattern;
+    pattern.compressPercentage = quint32(compressPercentage);
+    pattern.dedupePercentage = quint32(dedupePercentage);
+
+    const QString cachedFile = QDir(benchmarkPath).filePath(cachedFileName);
+    const quint64 bytes = quint64(fileSize) * 1024 * 1024;
 
-    if (!m_benchmarkFile.open()) {
-        return {{"success", false}, {"error", QStringLiteral("An error occurred while creating the benchmark file: %1").arg(m_benchmarkFile.errorString())}};
+    std::unique_ptr<QFile> benchmarkFile;
+
+    if (keepFile) {
+        const int fd = openNoFollow(cachedFile, O_RDWR | O_CREAT);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            const QString error = QString::fromLocal8Bit(strerror(fd < 0 ? errno : EINVAL));
+            if (fd >= 0) close(fd);
+            return {{"success", false}, {"error", QStringLiteral("An error occurred while opening the kept benchmark file: %1").arg(error)}};
+        }
+
+        benchmarkFile = std::make_unique<QFile>(cachedFile);
+        if (!benchmarkFile->open(fd, QIODevice::ReadWrite, QFileDevice::AutoCloseHandle)) {
+            close(fd);
+            return {{"success", false}, {"error", QStringLiteral("An error occurred while opening the kept benchmark file: %1").arg(benchmarkFile->errorString())}};
+        }
+
+        m_cachedFiles << cachedFile;
+        m_cachedZeros = fillZeros;
+        m_cachedPattern = pattern;
+
+        if (isCachedFileValid(cachedFile, fd, bytes, fillZeros, pattern)) {
+            m_benchmarkFiles.push_back(std::move(benchmarkFile));
+
+            // Nothing to write, so no task is started and the reply alone tells the GUI not to wait
+            return {{"success", true}, {"reused", true}};
+        }
+
+        // Stale until the session ends with the file fully written
+        QFile::remove(cachedMetadataPath(cachedFile));
+
+        if (ftruncate(fd, 0) != 0) {
+            return {{"success", false}, {"error", QStringLiteral("An error occurred while truncating the kept benchmark file: %1").arg(QString::fromLocal8Bit(strerror(errno)))}};
+        }
     }
+    else {
+        // A file kept by earlier sessions only takes up space now
+        QFile::remove(cachedFile);
+        QFile::remove(cachedMetadataPath(cachedFile));
 
-    m_process = new QProcess();
-    m_process->start("fio", QStringList()
-                     << QStringLiteral("--output-format=json")
-                     << QStringLiteral("--create_only=1")
-                     << QStringLiteral("--filename=%1").arg(m_benchmarkFile.fileName())
-                     << QStringLiteral("--size=%1m").arg(fileSize)
-                     << QStringLiteral("--zero_buffers=%1").arg(fillZeros)
-                     << QStringLiteral("--name=prepare"));
+        auto temporaryFile = std::make_unique<QTemporaryFile>(QStringLiteral("%1/%2").arg(benchmarkPath).arg("kdiskmark-XXXXXX.tmp"));
 
-    connect(m_process, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
-            [=] (int exitCode, QProcess::ExitStatus exitStatus) {
-        emit taskFinished(exitStatus == QProcess::NormalExit, QString(m_process->readAllStandardOutput()), QString(m_process->readAllStandardError()));
+        if (!temporaryFile->open()) {
+            return {{"success", false}, {"error", QStringLiteral("An error occurred while creating the benchmark file: %1").arg(temporaryFile->errorString())}};
+        }
+
+        benchmarkFile = std::move(temporaryFile);
+    }
+
+    FilePreparer::Params params;
+    params.fileName = QFile::encodeName(benchmarkFile->fileName()).toStdString();
+    params.fileSize = bytes;
+    params.fillZeros = fillZeros;
+    params.pattern = pattern;
+
+    m_benchmarkFiles.push_back(std::move(benchmarkFile));
+
+    m_preparer = std::make_unique<FilePreparer>(params);
+    m_preparer->start([this] {
+        QMetaObject::invokeMethod(this, [this] { finishPreparation(); }, Qt::QueuedConnection);
     });
+    m_progressTimer->start();
 
     return {{"success", true}};
 }
 
+QVariantMap Helper::prepareFileSet(int files, int fileSize, bool fillZeros, int compressPercentage, int dedupePercentage)
+{
+    if (!isCallerAuthorized()) {
+        return {};
+    }
+
+    if (!hasTargets()) {
+        return {{"success", false}, {"error", "The benchmark file was not pre-created."}};
+    }
+
+    // The set is created next to the benchmark file, a raw device has no directory to hold it
+    if (!m_rawDevice.isEmpty()) {
+        return {{"success", false}, {"error", "A file set needs a directory, not a raw device."}};
+    }
+
+    if (m_benchmarkFiles.size() > 1) {
+        return {{"success", false}, {"error", "A file set is tested on a single target."}};
+    }
+
+    if (files < 1 || files > 10000000 || fileSize < 1 || fileSize > 1024 * 1024 ||
+        compressPercentage < 0 || compressPercentage > 100 || dedupePercentage < 0 || dedupePercentage > 100) {
+        return {{"success", false}, {"error", "Invalid file set parameters."}};
+    }
+
+    if (m_preparer && m_preparer->isRunning()) {
+        return {{"success", false}, {"error", "A preparation is already running."}};
+    }
+
+    // A set of another shape is replaced rather than extended
+    m_fileSet.reset();
+
+    auto fileSet = std::make_unique<QTemporaryDir>(QFileInfo(m_benchmarkFiles.front()->fileName()).absoluteDir().filePath(QStringLiteral("kdiskmark-files-XXXXXX")));
+    if (!fileSet->isValid()) {
+        return {{"success", false}, {"error", QStringLiteral("An error occurred while creating the file set directory: %1").arg(fileSet->errorString())}};
+    }
+
+    FilePreparer::Params params;
+    params.fileName = QFile::encodeName(fileSet->path()).toStdString();
+    params.fileSize = quint64(fileSize) * 1024;
+    params.files = quint32(files);
+    params.fillZeros = fillZeros;
+    params.pattern.compressPercentage = quint32(compressPercentage);
+    params.pattern.dedupePercentage = quint32(dedupePercentage);
+
+    m_fileSet = std::move(fileSet);
+    m_fileSetFiles = files;
+    m_fileSetSize = fileSize;
+
+    m_preparer = std::make_unique<FilePreparer>(params);
+    m_preparer->start([this] {
+        QMetaObject::invokeMethod(this, [this] { finishPreparation(); }, Qt::QueuedConnection);
+    });
+    m_progressTimer->start();
+
+    return {{"success", true}};
+}
+
+void Helper::finishPreparation()
+{
+    if (!m_preparer || m_preparer->isRunning()) {
+        return;
+    }
+
+    m_progressTimer->stop();
+
+    // A partially written file must not be picked up again, nor a partially populated set tested
+    if (!m_preparer->isComplete()) {
+        m_cachedFiles.removeAll(QFile::decodeName(m_preparer->params().fileName.c_str()));
+        if (m_preparer->params().files > 0) m_fileSet.reset();
+    }
+
+    const int error = m_preparer->error();
+    emit taskFinished(error == 0, preparationReport(*m_preparer), error != 0 ? QString::fromLocal8Bit(strerror(error)) : QString());
+
+    m_preparer.reset();
+}
+
+QVariantMap Helper::prepareRawDevice(const QString &device)
+{
+    if (!isCallerAuthorized()) {
+        return {};
+    }
+
+    if (!m_rawDevice.isEmpty() || !m_benchmarkFiles.empty()) {
+        return {{"success", false}, {"error", "A new benchmark session should be started."}};
+    }
+
+    // Reading a whole device goes around file permissions, so it is authorized separately from the session
+    if (!isActionAuthorized(QStringLiteral("dev.jonmagon.kdiskmark.helper.rawdevice"))) {
+        sendErrorReply(QDBusError::AccessDenied);
+        return {};
+    }
+
+    const QString path = QFileInfo(device).canonicalFilePath();
+
+    struct stat st;
+    if (!path.startsWith(QLatin1String("/dev/")) || stat(QFile::encodeName(path).constData(), &st) != 0 || !S_ISBLK(st.st_mode)) {
+        return {{"success", false}, {"error", QStringLiteral("%1 is not a block device.").arg(device)}};
+    }
+
+    int fd = open(QFile::encodeName(path).constData(), O_RDONLY | O_DIRECT);
+    if (fd < 0) {
+        return {{"success", false}, {"error", QStringLiteral("Cannot open %1: %2").arg(path, strerror(errno))}};
+    }
+
+    quint64 size = 0;
+    bool sized = ioctl(fd, BLKGETSIZE64, &size) == 0;
+    close(fd);
+
+    if (!sized || size == 0) {
+        return {{"success", false}, {"error", QStringLiteral("Cannot determine the size of %1.").arg(path)}};
+    }
+
+    m_rawDevice = path;
+    m_rawDeviceSize = size;
+
+    return {{"success", true}, {"size", size}};
+}
+
+QVariantMap Helper::loadTrace(const QDBusUnixFileDescriptor &trace, int speed)
+{
+    if (!isCallerAuthorized()) {
+        return {};
+    }
+
+    if (!hasTargets()) {
+        return {{"success", false}, {"error", "The benchmark file was not pre-created."}};
+    }
+
+    if (m_benchmarkFiles.size() > 1) {
+        return {{"success", false}, {"error", "A trace is replayed on a single target."}};
+    }
+
+    if (!trace.isValid() || speed < 0 || speed > 10000) {
+        return {{"success", false}, {"error", "Invalid trace replay parameters."}};
+    }
+
+    // The caller opened the trace, so it is read with their permissions rather than root's
+    QFile traceFile;
+    if (!traceFile.open(trace.fileDescriptor(), QIODevice::ReadOnly)) {
+        return {{"success", false}, {"error", QStringLiteral("Cannot read the trace: %1").arg(traceFile.errorString())}};
+    }
+
+    auto traceDir = std::make_unique<QTemporaryDir>();
+    if (!traceDir->isValid()) {
+        return {{"success", false}, {"error", QStringLiteral("Cannot create the replay log: %1").arg(traceDir->errorString())}};
+    }
+
+    const bool rawDevice = !m_rawDevice.isEmpty();
+    const QString target = rawDevice ? m_rawDevice : m_benchmarkFiles.front()->fileName();
+    const quint64 targetSize = rawDevice ? m_rawDeviceSize : quint64(m_benchmarkFiles.front()->size());
+
+    // The log names the target on every line and fio splits them at whitespace, so it refers to a link
+    // with a plain name, which the replay job opens as well
+    const QString targetLink = traceDir->filePath(QStringLiteral("target"));
+    if (!QFile::link(target, targetLink)) {
+        return {{"success", false}, {"error", QStringLiteral("Cannot link the replay target in %1.").arg(traceDir->path())}};
+    }
+
+    QFile traceLog(traceDir->filePath(QStringLiteral("trace.log")));
+    if (!traceLog.open(QIODevice::WriteOnly)) {
+        return {{"success", false}, {"error", QStringLiteral("Cannot create the replay log: %1").arg(traceLog.errorString())}};
+    }
+
+    TraceReplay::Summary summary;
+    QString error = TraceReplay::convert(traceFile, targetLink, targetSize, speed, traceLog, summary);
+    if (!error.isEmpty()) {
+        return {{"success", false}, {"error", error}};
+    }
+
+    if (rawDevice && (summary.writes > 0 || summary.syncs > 0)) {
+        return {{"success", false}, {"error", "The raw device is read-only, but the trace contains writes."}};
+    }
+
+    traceLog.close();
+    m_traceDir = std::move(traceDir);
+
+    // Non-empty buckets only, the GUI rebuilds the histogram from them
+    QVariantMap originalLatency;
+    for (unsigned i = 0; i < LatencyHistogram::BucketCount && !summary.originalLatency.isEmpty(); i++) {
+        if (summary.originalLatency.bucket(i) > 0) {
+            originalLatency[QString::number(i)] = qulonglong(summary.originalLatency.bucket(i));
+        }
+    }
+
+    return {
+        {"success", true},
+        {"ios", qulonglong(summary.ios)},
+        {"reads", qulonglong(summary.reads)},
+        {"writes", qulonglong(summary.writes)},
+        {"syncs", qulonglong(summary.syncs)},
+        {"bytes", qulonglong(summary.bytes)},
+        {"duration", qulonglong(summary.durationNs / 1000000)},
+        {"originalLatency", originalLatency}
+    };
+}
+
 QVariantMap Helper::startBenchmarkTest(int measuringTime, int fileSize, int randomReadPercentage, bool fillZeros, bool cacheBypass, bool continuousGeneration,
-                                       int blockSize, int queueDepth, int threads, const QString &rw)
+                                       int blockSize, int queueDepth, int threads, const QString &rw, const QString &engine,
+                                       const QVariantMap &options)
 {
     if (!isCallerAuthorized()) {
         return {};
     }
 
-    if (m_benchmarkFile.fileName().isNull() || !QFile(m_benchmarkFile.fileName()).exists()) {
+    if (!hasTargets()) {
         return {{"success", false}, {"error", "The benchmark file was not pre-created."}};
     }
 
+    const bool rawDevice = !m_rawDevice.isEmpty();
+
+    // rw also ends up in the job file of the FIO server, only the known patterns may pass
+    static const QStringList patterns = { "read", "write", "rw", "randread", "randwrite", "randrw", "trace" };
+    if (!patterns.contains(rw)) {
+        return {{"success", false}, {"error", QStringLiteral("The %1 pattern is not supported.").arg(rw)}};
+    }
+
+    const bool trace = rw == QLatin1String("trace");
+
+    if (trace && !m_traceDir) {
+        return {{"success", false}, {"error", "No trace was loaded."}};
+    }
+
+    // The set of small files is tested instead of the benchmark file, the option itself never reaches fio
+    const bool fileSet = options.contains(QStringLiteral("fileset"));
+
+    if (fileSet && !m_fileSet) {
+        return {{"success", false}, {"error", "No file set was prepared."}};
+    }
+
+    if (fileSet && (trace || engine == QLatin1String("native"))) {
+        return {{"success", false}, {"error", "A file set is only tested by fio with the usual patterns."}};
+    }
+
+    // A trace with writes is refused by loadTrace in that case
+    if (rawDevice && !trace && rw != QLatin1String("read") && rw != QLatin1String("randread")) {
+        return {{"success", false}, {"error", QStringLiteral("The raw device is read-only, the %1 pattern is not allowed.").arg(rw)}};
+    }
+
+    const DataPattern pattern = dataPattern(options);
+
+    // Writes of the other test data leave the kept files with mixed contents
+    if ((fillZeros != m_cachedZeros || (!fillZeros && pattern != m_cachedPattern)) &&
+        rw != QLatin1String("read") && rw != QLatin1String("randread")) {
+        m_cachedFiles.clear();
+    }
+
+    if (engine == QLatin1String("native")) {
+        if (trace) {
+            return {{"success", false}, {"error", "The native engine cannot replay traces."}};
+        }
+
+        if (m_benchmarkFiles.size() > 1) {
+            return {{"success", false}, {"error", "The native engine does not support several targets."}};
+        }
+
+        QStringList nativeOptions;
+        QString error;
+        if (!appendJobOptions(options, nativeOptions, error)) {
+            return {{"success", false}, {"error", error}};
+        }
+
+        static const QStringList supported = { "cpus_allowed", "cpus_allowed_policy", "numa_cpu_nodes", "numa_mem_policy",
+                                               "buffer_compress_percentage", "dedupe_percentage" };
+        for (const QString &key : options.keys()) {
+            if (!supported.contains(key)) {
+                return {{"success", false}, {"error", QStringLiteral("The native engine does not support the %1 option.").arg(key)}};
+            }
+        }
+
+        // Jobs allocate their buffers after pinning, so first touch keeps memory on the job's node
+        if (options.contains("numa_mem_policy") && options.value("numa_mem_policy").toString() != QLatin1String("local")) {
+            return {{"success", false}, {"error", QStringLiteral("The native engine only supports numa_mem_policy=local.")}};
+        }
+
+        UringEngine::Params params;
+        params.fileName = QFile::encodeName(rawDevice ? m_rawDevice : m_benchmarkFiles.front()->fileName()).toStdString();
+        params.fileSize = rawDevice ? m_rawDeviceSize : quint64(fileSize) * 1024 * 1024;
+        params.measuringTime = measuringTime;
+        params.readPercentage = rw.endsWith(QLatin1String("read")) ? 100 : rw.endsWith(QLatin1String("write")) ? 0 : randomReadPercentage;
+        params.random = rw.startsWith(QLatin1String("rand"));
+        params.fillZeros = fillZeros;
+        params.pattern = pattern;
+        params.cacheBypass = cacheBypass || rawDevice;
+        params.continuousGeneration = continuousGeneration;
+        params.blockSize = quint32(blockSize) * 1024;
+        params.queueDepth = quint32(queueDepth);
+        params.threads = quint32(threads);
+        params.cpus = options.contains("cpus_allowed") ? parseCpuList(options.value("cpus_allowed").toString())
+                                                       : numaNodeCpus(options.value("numa_cpu_nodes").toString());
+
+        if (params.cpus.empty() && options.contains("numa_cpu_nodes")) {
+            return {{"success", false}, {"error", QStringLiteral("The NUMA nodes %1 have no CPUs.").arg(options.value("numa_cpu_nodes").toString())}};
+        }
+        params.splitCpus = options.value("cpus_allowed_policy").toString() == QLatin1String("split");
+
+        m_engine = std::make_unique<UringEngine>(params);
+        m_engine->start([this] {
+            QMetaObject::invokeMethod(this, [this] { finishNativeTask(); }, Qt::QueuedConnection);
+        });
+        m_progressTimer->start();
+
+        return {{"success", true}};
+    }
+
+    QStringList jobOptions = {
+        QStringLiteral("ioengine=libaio"),
+        QStringLiteral("randrepeat=0"),
+        // A buffer filled once would repeat in every write and deduplicate regardless of dedupe_percentage
+        QStringLiteral("refill_buffers=%1").arg(continuousGeneration || !pattern.isRandom()),
+        QStringLiteral("end_fsync=1"),
+        QStringLiteral("direct=%1").arg(cacheBypass),
+        QStringLiteral("rwmixread=%1").arg(randomReadPercentage),
+        QStringLiteral("size=%1m").arg(fileSize),
+        QStringLiteral("zero_buffers=%1").arg(fillZeros),
+        QStringLiteral("bs=%1k").arg(blockSize),
+        QStringLiteral("runtime=%1").arg(measuringTime),
+        QStringLiteral("rw=%1").arg(rw),
+        QStringLiteral("iodepth=%1").arg(queueDepth),
+        QStringLiteral("numjobs=%1").arg(threads)
+    };
+
+    // Without a size fio covers the whole LBA range, the page cache is always bypassed and nothing is synced
+    if (rawDevice) {
+        jobOptions.removeAll(QStringLiteral("end_fsync=1"));
+        jobOptions.removeAll(QStringLiteral("size=%1m").arg(fileSize));
+        jobOptions.replaceInStrings(QStringLiteral("direct=0"), QStringLiteral("direct=1"));
+    }
+
+    // Offsets, sizes and timing all come from the log
+    if (trace) {
+        jobOptions.removeAll(QStringLiteral("rw=%1").arg(rw));
+        jobOptions.removeAll(QStringLiteral("bs=%1k").arg(blockSize));
+        jobOptions << QStringLiteral("read_iolog=%1").arg(m_traceDir->filePath(QStringLiteral("trace.log")));
+    }
+
+    // Every job goes through the whole set. The names leave out the job number, so the jobs share the files.
+    if (fileSet) {
+        jobOptions.removeAll(QStringLiteral("size=%1m").arg(fileSize));
+        jobOptions << QStringLiteral("directory=%1").arg(m_fileSet->path())
+                   << QStringLiteral("nrfiles=%1").arg(m_fileSetFiles)
+                   << QStringLiteral("filesize=%1k").arg(m_fileSetSize)
+                   << QStringLiteral("size=%1k").arg(qint64(m_fileSetFiles) * m_fileSetSize)
+                   << QStringLiteral("filename_format=f.$filenum");
+    }
+
+    QVariantMap fioOptions = options;
+    fioOptions.remove(QStringLiteral("fileset"));
+
+    QString error;
+    if (!appendJobOptions(fioOptions, jobOptions, error)) {
+        return {{"success", false}, {"error", error}};
+    }
+
+    // One job per target, all started together by the same fio run. The GUI tells the targets apart by the job name.
+    // A job of the file set has no file name, its files come from the directory.
+    QVector<QPair<QString, QString>> jobs;
+    if (fileSet) {
+        jobs.append({ QStringLiteral("job"), QString() });
+    }
+    else {
+        for (size_t i = 0; i < m_benchmarkFiles.size(); i++) {
+            jobs.append({ m_benchmarkFiles.size() > 1 ? QStringLiteral("target%1").arg(i) : QStringLiteral("job"), m_benchmarkFiles[i]->fileName() });
+        }
+    }
+
+    if (rawDevice) {
+        jobs.append({ QStringLiteral("job"), m_rawDevice });
+    }
+
+    // The replay opens the target under the name the log uses
+    if (trace) {
+        jobs.first().second = m_traceDir->filePath(QStringLiteral("target"));
+    }
+
+    // A line break in a path would start a new option of the job file, a leading bracket a new section
+    QStringList paths = { fileSet ? m_fileSet->path() : QString() };
+    for (const auto &job : jobs) {
+        paths << job.second;
+    }
+
+    for (const QString &path : paths) {
+        if (path.contains('\n') || path.contains('\r') || path.startsWith('[')) {
+            return {{"success", false}, {"error", QStringLiteral("The path %1 cannot be passed to fio.").arg(path)}};
+        }
+    }
+
+    // Every interval fio prints a complete report with running totals, which is streamed as progress
+    // json+ adds the completion latency bins needed to merge distributions across jobs and loops
+    QStringList arguments = { QStringLiteral("--output-format=json+"), QStringLiteral("--status-interval=1") };
+
+    if (engine == QLatin1String("fio-server")) {
+        if (!startFioServer(rawDevice, error)) {
+            return {{"success", false}, {"error", error}};
+        }
+
+        // The client only ships a job file to the server, command line job options are not forwarded
+        QFile jobFile(m_fioServerDir->filePath(QStringLiteral("job.fio")));
+        if (!jobFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            return {{"success", false}, {"error", QStringLiteral("Cannot write the job file: %1").arg(jobFile.errorString())}};
+        }
+
+        jobFile.write(QStringLiteral("[global]\n%1\n").arg(jobOptions.join('\n')).toUtf8());
+        for (const auto &job : jobs) {
+            jobFile.write(QStringLiteral("[%1]\n").arg(job.first).toUtf8());
+            if (!job.second.isEmpty()) jobFile.write(QStringLiteral("filename=%1\n").arg(job.second).toUtf8());
+        }
+        jobFile.close();
+
+        arguments << QStringLiteral("--client=sock:%1").arg(m_fioServerDir->filePath(QStringLiteral("fio.sock")))
+                  << jobFile.fileName();
+    }
+    else {
+        // fio's own safety net against writes and trims
+        if (rawDevice) arguments << QStringLiteral("--readonly");
+
+        // Options given before the first job name are global
+        for (const QString &option : jobOptions) {
+            arguments << QStringLiteral("--%1").arg(option);
+        }
+        for (const auto &job : jobs) {
+            arguments << QStringLiteral("--name=%1").arg(job.first);
+            if (!job.second.isEmpty()) arguments << QStringLiteral("--filename=%1").arg(job.second);
+        }
+    }
+
+    m_processOutput.clear();
+    m_lastReport.clear();
+
     m_process = new QProcess();
-    m_process->start("fio", QStringList()
-                     << QStringLiteral("--output-format=json")
-                     << QStringLiteral("--ioengine=libaio")
-                     << QStringLiteral("--randrepeat=0")
-                     << QStringLiteral("--refill_buffers=%1").arg(continuousGeneration)
-                     << QStringLiteral("--end_fsync=1")
-                     << QStringLiteral("--direct=%1").arg(cacheBypass)
-                     << QStringLiteral("--rwmixread=%1").arg(randomReadPercentage)
-                     << QStringLiteral("--filename=%1").arg(m_benchmarkFile.fileName())
-                     << QStringLiteral("--name=%1").arg(rw)
-                     << QStringLiteral("--size=%1m").arg(fileSize)
-                     << QStringLiteral("--zero_buffers=%1").arg(fillZeros)
-                     << QStringLiteral("--bs=%1k").arg(blockSize)
-                     << QStringLiteral("--runtime=%1").arg(measuringTime)
-                     << QStringLiteral("--rw=%1").arg(rw)
-                     << QStringLiteral("--iodepth=%1").arg(queueDepth)
-                     << QStringLiteral("--numjobs=%1").arg(threads));
+
+    connect(m_process, &QProcess::readyReadStandardOutput, this, [this] {
+        m_processOutput += m_process->readAllStandardOutput();
+        for (const QByteArray &report : takeJsonDocuments(m_processOutput)) {
+            m_lastReport = report;
+            emit taskProgress(QString::fromUtf8(report));
+        }
+    });
 
     connect(m_process, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
             [=] (int exitCode, QProcess::ExitStatus exitStatus) {
-        emit taskFinished(exitStatus == QProcess::NormalExit, QString(m_process->readAllStandardOutput()), QString(m_process->readAllStandardError()));
+        m_processOutput += m_process->readAllStandardOutput();
+        for (const QByteArray &report : takeJsonDocuments(m_processOutput)) {
+            m_lastReport = report;
+        }
+        // The last report printed is the final one
+        emit taskFinished(exitStatus == QProcess::NormalExit, QString::fromUtf8(m_lastReport), QString(m_process->readAllStandardError()));
     });
 
+    m_process->start("fio", arguments);
+
     return {{"success", true}};
 }
 
+void Helper::finishNativeTask()
+{
+    if (!m_engine || m_engine->isRunning()) {
+        return;
+    }
+
+    m_progressTimer->stop();
+
+    QStringList errors;
+    QString report = nativeReport(m_engine->results(), &errors);
+    errors.removeDuplicates();
+
+    m_engine.reset();
+
+    emit taskFinished(true, report, errors.join('\n'));
+}
+
+QVariantMap Helper::startMetadataTest(int files, int filesPerDirectory, int threads)
+{
+    if (!isCallerAuthorized()) {
+        return {};
+    }
+
+    if (!hasTargets()) {
+        return {{"success", false}, {"error", "The benchmark file was not pre-created."}};
+    }
+
+    // The tree is generated next to the benchmark file, a raw device has no directory to hold it
+    if (!m_rawDevice.isEmpty()) {
+        return {{"success", false}, {"error", "The metadata test needs a directory, not a raw device."}};
+    }
+
+    if (m_benchmarkFiles.size() > 1) {
+        return {{"success", false}, {"error", "The metadata test runs on a single target."}};
+    }
+
+    if (files < 1 || files > 10000000 || filesPerDirectory < 1 || filesPerDirectory > 1000000 || threads < 1 || threads > 256) {
+        return {{"success", false}, {"error", "Invalid metadata test parameters."}};
+    }
+
+    if (m_metadataEngine && m_metadataEngine->isRunning()) {
+        return {{"success", false}, {"error", "A metadata test is already running."}};
+    }
+
+    MetadataEngine::Params params;
+    params.directory = QFile::encodeName(QFileInfo(m_benchmarkFiles.front()->fileName()).absolutePath()).toStdString();
+    params.files = quint32(files);
+    params.filesPerDirectory = quint32(filesPerDirectory);
+    params.threads = quint32(threads);
+
+    m_metadataEngine = std::make_unique<MetadataEngine>(params);
+    m_metadataEngine->start([this] {
+        QMetaObject::invokeMethod(this, [this] { finishMetadataTask(); }, Qt::QueuedConnection);
+    });
+    m_progressTimer->start();
+
+    return {{"success", true}};
+}
+
+void Helper::finishMetadataTask()
+{
+    if (!m_metadataEngine || m_metadataEngine->isRunning()) {
+        return;
+    }
+
+    m_progressTimer->stop();
+
+    const int error = m_metadataEngine->error();
+    emit taskFinished(error == 0, metadataReport(m_metadataEngine->results()), error != 0 ? QString::fromLocal8Bit(strerror(error)) : QString());
+
+    m_metadataEngine.reset();
+}
+
 QVariantMap Helper::flushPageCache()
 {
     if (!isCallerAuthorized()) {
         return {};
     }
 
-    if (m_benchmarkFile.fileName().isNull() || !QFile(m_benchmarkFile.fileName()).exists()) {
+    if (!hasTargets()) {
         return {{"success", false}, {"error", "A benchmark file must first be created."}};
     }
 
@@ -272,13 +1214,113 @@ QVariantMap Helper::removeBenchmarkFile()
         return {};
     }
 
-    if (m_benchmarkFile.fileName().isNull() || !QFile(m_benchmarkFile.fileName()).exists()) {
+    if (!hasTargets()) {
         return {{"success", false}, {"error", "Cannot remove the benchmark file, because it doesn't exist."}};
     }
 
-    m_benchmarkFile.close();
+    stopFioServer();
+
+    if (m_preparer) {
+        m_preparer->stop();
+        if (!m_preparer->isComplete()) {
+            m_cachedFiles.removeAll(QFile::decodeName(m_preparer->params().fileName.c_str()));
+        }
+        m_preparer.reset();
+    }
+
+    m_traceDir.reset();
+
+    // Removed together with all of its files
+    m_fileSet.reset();
+
+    // Stopping removes the generated tree
+    m_metadataEngine.reset();
 
-    return {{"success", m_benchmarkFile.remove()}};
+    // Nothing was created on a raw device
+    if (!m_rawDevice.isEmpty()) {
+        m_rawDevice.clear();
+        m_rawDeviceSize = 0;
+        return {{"success", true}};
+    }
+
+    bool success = true;
+    for (const auto &benchmarkFile : m_benchmarkFiles) {
+        // The stamp is taken after the tests, so their writes don't invalidate the file
+        if (m_cachedFiles.contains(benchmarkFile->fileName()) &&
+            writeCachedFileStamp(benchmarkFile->fileName(), benchmarkFile->handle(), m_cachedZeros, m_cachedPattern)) {
+            benchmarkFile->close();
+            continue;
+        }
+
+        benchmarkFile->close();
+        success = benchmarkFile->remove() && success;
+        QFile::remove(cachedMetadataPath(benchmarkFile->fileName()));
+    }
+
+    m_benchmarkFiles.clear();
+    m_cachedFiles.clear();
+
+    return {{"success", success}};
+}
+
+bool Helper::startFioServer(bool readOnly, QString &error)
+{
+    // --readonly only guards the jobs of the process that runs them, a server started without it is replaced
+    if (m_fioServer && m_fioServer->state() == QProcess::Running && m_fioServerReadOnly == readOnly) {
+        return true;
+    }
+
+    stopFioServer();
+
+    // QTemporaryDir is only accessible by its owner, which keeps the socket private to the helper
+    m_fioServerDir = std::make_unique<QTemporaryDir>();
+    if (!m_fioServerDir->isValid()) {
+        error = QStringLiteral("Cannot create a directory for the FIO server: %1").arg(m_fioServerDir->errorString());
+        return false;
+    }
+
+    const QString socket = m_fioServerDir->filePath(QStringLiteral("fio.sock"));
+
+    QStringList arguments = { QStringLiteral("--server=sock:%1").arg(socket) };
+    if (readOnly) arguments << QStringLiteral("--readonly");
+
+    m_fioServer = new QProcess(this);
+    m_fioServerReadOnly = readOnly;
+    m_fioServer->start("fio", arguments);
+
+    if (!m_fioServer->waitForStarted()) {
+        error = QStringLiteral("Cannot start the FIO server: %1").arg(m_fioServer->errorString());
+        stopFioServer();
+        return false;
+    }
+
+    // The server does not report readiness other than by creating its socket
+    QElapsedTimer timer;
+    timer.start();
+    while (!QFileInfo::exists(socket)) {
+        if (m_fioServer->state() != QProcess::Running || timer.hasExpired(5000)) {
+            error = QStringLiteral("The FIO server did not start: %1").arg(QString(m_fioServer->readAllStandardError()));
+            stopFioServer();
+            return false;
+        }
+        QThread::msleep(10);
+    }
+
+    return true;
+}
+
+void Helper::stopFioServer()
+{
+    if (m_fioServer) {
+        if (m_fioServer->state() != QProcess::NotRunning) {
+            m_fioServer->terminate();
+            m_fioServer->waitForFinished();
+        }
+        m_fioServer->deleteLater();
+        m_fioServer = nullptr;
+    }
+
+    m_fioServerDir.reset();
 }
 
 QVariantMap Helper::stopCurrentTask()
@@ -287,7 +1329,24 @@ QVariantMap Helper::stopCurrentTask()
         return {};
     }
 
+    if (m_engine) {
+        m_progressTimer->stop();
+        m_engine->stop();
+    }
+
+    if (m_preparer) {
+        m_progressTimer->stop();
+        m_preparer->stop();
+    }
+
+    // Returns once the generated tree is removed
+    if (m_metadataEngine) {
+        m_progressTimer->stop();
+        m_metadataEngine->stop();
+    }
+
     if (!m_process) {
+        if (m_engine || m_preparer || m_metadataEngine) return {{"success", true}};
         return {{"success", false}, {"error", "The pointer to the process is empty."}};
     }
 
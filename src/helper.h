@@ -1,10 +1,18 @@
 #include <QDBusAbstractAdaptor>
 #include <QDBusContext>
+#include <QDBusUnixFileDescriptor>
 #include <QEventLoop>
 #include <QProcess>
+#include <QTemporaryDir>
 #include <QTemporaryFile>
+#include <QTimer>
 
 #include <memory>
+#include <vector>
+
+#include "uringengine.h"
+#include "filepreparer.h"
+#include "metadataengine.h"
 
 class Helper;
 class QDBusServiceWatcher;
@@ -20,11 +28,17 @@ public:
 public slots:
     Q_SCRIPTABLE QVariantMap initSession();
     Q_SCRIPTABLE QVariantMap endSession();
-    Q_SCRIPTABLE QVariantMap prepareBenchmarkFile(const QString &benchmarkPath, int fileSize, bool fillZeros);
+    Q_SCRIPTABLE QVariantMap prepareBenchmarkFile(const QString &benchmarkPath, int fileSize, bool fillZeros, bool keepFile,
+                                              int compressPercentage, int dedupePercentage);
+    Q_SCRIPTABLE QVariantMap prepareRawDevice(const QString &device);
+    Q_SCRIPTABLE QVariantMap prepareFileSet(int files, int fileSize, bool fillZeros, int compressPercentage, int dedupePercentage);
+    Q_SCRIPTABLE QVariantMap loadTrace(const QDBusUnixFileDescriptor &trace, int speed);
     Q_SCRIPTABLE QVariantMap startBenchmarkTest(
         int measuringTime, int fileSize, int randomReadPercentage,
         bool fillZeros, bool cacheBypass, bool continuousGeneration,
-        int blockSize, int queueDepth, int threads, const QString &rw);
+        int blockSize, int queueDepth, int threads, const QString &rw,
+        const QString &engine, const QVariantMap &options);
+    Q_SCRIPTABLE QVariantMap startMetadataTest(int files, int filesPerDirectory, int threads);
     Q_SCRIPTABLE QVariantMap flushPageCache();
     Q_SCRIPTABLE QVariantMap removeBenchmarkFile();
     Q_SCRIPTABLE QVariantMap stopCurrentTask();
@@ -33,6 +47,7 @@ public slots:
 
 signals:
     Q_SCRIPTABLE void taskFinished(bool, QString, QString);
+    Q_SCRIPTABLE void taskProgress(QString);
 
 private:
     Helper *m_parentHelper;
@@ -48,12 +63,18 @@ public:
 public:
     QVariantMap initSession();
     QVariantMap endSession();
-    QVariantMap prepareBenchmarkFile(const QString &benchmarkPath, int fileSize, bool fillZeros);
+    QVariantMap prepareBenchmarkFile(const QString &benchmarkPath, int fileSize, bool fillZeros, bool keepFile,
+                                     int compressPercentage, int dedupePercentage);
+    QVariantMap prepareRawDevice(const QString &device);
+    QVariantMap prepareFileSet(int files, int fileSize, bool fillZeros, int compressPercentage, int dedupePercentage);
+    QVariantMap loadTrace(const QDBusUnixFileDescriptor &trace, int speed);
     QVariantMap startBenchmarkTest(int measuringTime, int fileSize,
                                    int randomReadPercentage, bool fillZeros,
                                    bool cacheBypass, bool continuousGeneration,
                                    int blockSize, int queueDepth, int threads,
-                                   const QString &rw);
+                                   const QString &rw, const QString &engine,
+                                   const QVariantMap &options);
+    QVariantMap startMetadataTest(int files, int filesPerDirectory, int threads);
     QVariantMap flushPageCache();
     QVariantMap removeBenchmarkFile();
     QVariantMap stopCurrentTask();
@@ -62,15 +83,46 @@ public:
 
 private:
     bool isCallerAuthorized();
+    bool isActionAuthorized(const QString &action);
     bool testFilePath(const QString &benchmarkPath);
+    bool hasTargets() const;
+    void finishNativeTask();
+    void finishMetadataTask();
+    void finishPreparation();
+    bool startFioServer(bool readOnly, QString &error);
+    void stopFioServer();
 
 signals:
     void taskFinished(bool, QString, QString);
+    void taskProgress(QString);
 
 private:
     HelperAdaptor *m_helperAdaptor;
     QDBusServiceWatcher *m_serviceWatcher = nullptr;
 
-    QProcess *m_process;
-    QTemporaryFile m_benchmarkFile;
+    QProcess *m_process = nullptr;
+    QProcess *m_fioServer = nullptr;
+    std::unique_ptr<QTemporaryDir> m_fioServerDir;
+    bool m_fioServerReadOnly = false;
+    std::unique_ptr<UringEngine> m_engine;
+    std::unique_ptr<FilePreparer> m_preparer;
+    std::unique_ptr<MetadataEngine> m_metadataEngine;
+    QTimer *m_progressTimer;
+    QByteArray m_processOutput;
+    QByteArray m_lastReport;
+    // One file per target, all of them are benchmarked together
+    std::vector<std::unique_ptr<QFile>> m_benchmarkFiles;
+    // Files of m_benchmarkFiles to keep for the next sessions, the others are removed
+    QStringList m_cachedFiles;
+    bool m_cachedZeros = false;
+    DataPattern m_cachedPattern;
+    // Block device benchmarked in place instead of the files, reads only
+    QString m_rawDevice;
+    quint64 m_rawDeviceSize = 0;
+    // fio iolog of the loaded trace, replayed by the "trace" pattern, and the link to the target it names
+    std::unique_ptr<QTemporaryDir> m_traceDir;
+    // Directory of small files next to the benchmark file, tested instead of it with the "fileset" option
+    std::unique_ptr<QTemporaryDir> m_fileSet;
+    int m_fileSetFiles = 0;
+    int m_fileSetSize = 0; // KiB per file
 };
@@ -0,0 +1,143 @@
+#include "histogramwidget.h"
+
+#include <QPainter>
+#include <QLocale>
+
+#include "global.h"
+
+namespace {
+// fio buckets merged into one bar, 8 bars per power of two
+constexpr unsigned BarWidth = 8;
+constexpr unsigned ExactBuckets = LatencyHistogram::BucketsPerGroup << 1;
+}
+
+HistogramWidget::HistogramWidget(const LatencyHistogram &histogram, QWidget *parent)
+    : QWidget(parent)
+    , m_histogram(histogram)
+{
+    setBackgroundRole(QPalette::Base);
+    setAutoFillBackground(true);
+}
+
+void HistogramWidget::setHistogram(const LatencyHistogram &histogram)
+{
+    m_histogram = histogram;
+    update();
+}
+
+QSize HistogramWidget::sizeHint() const
+{
+    return QSize(720, 400);
+}
+
+QString HistogramWidget::formatTime(double ns)
+{
+    QLocale locale = QLocale();
+
+    if (ns < 1000) return tr("%1 ns").arg(locale.toString(ns, 'f', 0));
+    if (ns < 1000000) return tr("%1 μs").arg(locale.toString(ns / 1000, 'g', 3));
+    if (ns < 1000000000) return tr("%1 ms").arg(locale.toString(ns / 1000000, 'g', 3));
+    return tr("%1 s").arg(locale.toString(ns / 1000000000, 'g', 3));
+}
+
+void HistogramWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+
+    const QColor text = palette().color(QPalette::Text);
+    const QFontMetrics metrics = fontMetrics();
+
+    if (m_histogram.isEmpty()) {
+        painter.setPen(text);
+        painter.drawText(rect(), Qt::AlignCenter, tr("No latency data"));
+        return;
+    }
+
+    // Bar 0 holds everything below 128 ns, the rest follow the bucket layout
+    const unsigned barCount = 1 + (LatencyHistogram::BucketCount - ExactBuckets) / BarWidth;
+    QVector<quint64> bars(barCount, 0);
+
+    for (unsigned i = 0; i < LatencyHistogram::BucketCount; i++) {
+        bars[i < ExactBuckets ? 0 : 1 + (i - ExactBuckets) / BarWidth] += m_histogram.bucket(i);
+    }
+
+    int first = 0, last = barCount - 1;
+    while (first < last && bars[first] == 0) first++;
+    while (last > first && bars[last] == 0) last--;
+
+    // Start and end on a power of two so the axis labels line up
+    const unsigned barsPerGroup = LatencyHistogram::BucketsPerGroup / BarWidth;
+    if (first > 0) first = 1 + (first - 1) / barsPerGroup * barsPerGroup;
+    last = qMin<int>(barCount - 1, (last - 1) / barsPerGroup * barsPerGroup + barsPerGroup);
+
+    quint64 maxBar = 0;
+    for (int i = first; i <= last; i++) maxBar = qMax(maxBar, bars[i]);
+
+    const QRect plot = rect().adjusted(metrics.height() * 4, metrics.height() * 3, -metrics.height(), -metrics.height() * 2);
+    if (plot.width() <= 0 || plot.height() <= 0) return;
+
+    const double barWidth = double(plot.width()) / (last - first + 1);
+    const double total = m_histogram.count();
+    const double maxShare = maxBar / total * 100;
+
+    // Lower bound of the first bucket in a bar
+    auto barStart = [] (int bar) -> double {
+        if (bar == 0) return 0;
+        const unsigned index = ExactBuckets + (bar - 1) * BarWidth;
+        const unsigned errorBits = (index >> LatencyHistogram::Bits) - 1;
+        return double(quint64(1) << (errorBits + LatencyHistogram::Bits)) + double(quint64(index % LatencyHistogram::BucketsPerGroup) << errorBits);
+    };
+
+    QColor grid = text;
+    grid.setAlpha(40);
+
+    for (int i = 0; i <= 4; i++) {
+        const double y = plot.bottom() - plot.height() * i / 4.;
+        painter.setPen(grid);
+        painter.drawLine(QPointF(plot.left(), y), QPointF(plot.right(), y));
+        painter.setPen(text);
+        painter.drawText(QRectF(0, y - metrics.height() / 2., plot.left() - 4, metrics.height()),
+                         Qt::AlignRight | Qt::AlignVCenter,
+                         QStringLiteral("%1%").arg(QLocale().toString(maxShare * i / 4, 'f', maxShare < 4 ? 2 : 1)));
+    }
+
+    const QColor barColor = palette().color(QPalette::Highlight);
+
+    for (int i = first; i <= last; i++) {
+        const double x = plot.left() + (i - first) * barWidth;
+
+        if (bars[i] > 0) {
+            const double height = bars[i] / double(maxBar) * plot.height();
+            painter.fillRect(QRectF(x + 1, plot.bottom() - height, qMax(1., barWidth - 1), height), barColor);
+        }
+
+        if (i == 0 || (i - 1) % barsPerGroup == 0) {
+            painter.setPen(grid);
+            painter.drawLine(QPointF(x, plot.top()), QPointF(x, plot.bottom()));
+            painter.setPen(text);
+            painter.drawText(QRectF(x - 50, plot.bottom() + 2, 100, metrics.height()), Qt::AlignCenter,
+                             formatTime(barStart(i)));
+        }
+    }
+
+    // Percentile markers
+    QStringList summary = { tr("%1 samples").arg(QLocale().toString(qulonglong(m_histogram.count()))) };
+
+    for (double percent : Global::getLatencyPercentiles()) {
+        const quint64 value = m_histogram.percentile(percent);
+        const unsigned index = LatencyHistogram::bucketIndex(value);
+        const int bar = index < ExactBuckets ? 0 : 1 + (index - ExactBuckets) / BarWidth;
+        const double x = plot.left() + (bar - first + 0.5) * barWidth;
+
+        QColor marker = text;
+        marker.setAlpha(120);
+        painter.setPen(QPen(marker, 1, Qt::DashLine));
+        painter.drawLine(QPointF(x, plot.top()), QPointF(x, plot.bottom()));
+
+        summary << QStringLiteral("p%1 %2").arg(QLocale().toString(percent), formatTime(value));
+    }
+
+    painter.setPen(text);
+    painter.drawRect(plot);
+    painter.drawText(QRect(plot.left(), 0, plot.width(), metrics.height() * 2), Qt::AlignCenter, summary.join(QStringLiteral("   ")));
+}
@@ -0,0 +1,30 @@
+#ifndef HISTOGRAMWIDGET_H
+#define HISTOGRAMWIDGET_H
+
+#include <QWidget>
+
+#include "latencyhistogram.h"
+
+// Completion latency distribution on a logarithmic time axis,
+// every power of two is drawn as a fixed number of bars
+class HistogramWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit HistogramWidget(const LatencyHistogram &histogram, QWidget *parent = nullptr);
+
+    void setHistogram(const LatencyHistogram &histogram);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    static QString formatTime(double ns);
+
+    LatencyHistogram m_histogram;
+};
+
+#endif // HISTOGRAMWIDGET_H
@@ -0,0 +1,85 @@
+#include "latencyhistogram.h"
+
+#include <cmath>
+
+unsigned LatencyHistogram::bucketIndex(uint64_t ns)
+{
+    if (ns < (BucketsPerGroup << 1)) return unsigned(ns);
+
+    const unsigned msb = 63 - __builtin_clzll(ns);
+    const unsigned errorBits = msb - Bits;
+    const unsigned base = (errorBits + 1) << Bits;
+    const unsigned offset = (BucketsPerGroup - 1) & (ns >> errorBits);
+
+    const unsigned index = base + offset;
+    return index < BucketCount ? index : BucketCount - 1;
+}
+
+uint64_t LatencyHistogram::bucketValue(unsigned index)
+{
+    if (index < (BucketsPerGroup << 1)) return index;
+
+    const unsigned errorBits = (index >> Bits) - 1;
+    const uint64_t base = uint64_t(1) << (errorBits + Bits);
+    const uint64_t k = index % BucketsPerGroup;
+
+    return base + uint64_t((k + 0.5) * (uint64_t(1) << errorBits));
+}
+
+void LatencyHistogram::add(uint64_t ns, uint64_t count)
+{
+    if (count == 0) return;
+
+    if (m_buckets.empty()) m_buckets.resize(BucketCount);
+
+    m_buckets[bucketIndex(ns)] += count;
+    m_count += count;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    if (other.m_count == 0) return;
+
+    if (m_buckets.empty()) m_buckets.resize(BucketCount);
+
+    for (unsigned i = 0; i < BucketCount; i++) {
+        m_buckets[i] += other.m_buckets[i];
+    }
+    m_count += other.m_count;
+}
+
+void LatencyHistogram::clear()
+{
+    m_buckets.clear();
+    m_count = 0;
+}
+
+bool LatencyHistogram::isEmpty() const
+{
+    return m_count == 0;
+}
+
+uint64_t LatencyHistogram::count() const
+{
+    return m_count;
+}
+
+uint64_t LatencyHistogram::bucket(unsigned index) const
+{
+    return index < m_buckets.size() ? m_buckets[index] : 0;
+}
+
+uint64_t LatencyHistogram::percentile(double percent) const
+{
+    if (m_count == 0) return 0;
+
+    const double target = std::ceil(m_count * percent / 100.0);
+    uint64_t seen = 0;
+
+    for (unsigned i = 0; i < BucketCount; i++) {
+        seen += m_buckets[i];
+        if (seen > 0 && seen >= target) return bucketValue(i);
+    }
+
+    return bucketValue(BucketCount - 1);
+}
@@ -0,0 +1,39 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+// Completion latency distribution in nanoseconds with the same log-linear bucket
+// layout fio uses for its json+ output: values below 128 ns are exact, above that
+// each power of two is split into 64 buckets. The layout is fixed, so memory use
+// does not depend on run time and histograms can be merged bucket by bucket.
+class LatencyHistogram
+{
+public:
+    static constexpr unsigned Bits = 6;
+    static constexpr unsigned BucketsPerGroup = 1 << Bits;
+    static constexpr unsigned GroupCount = 29;
+    static constexpr unsigned BucketCount = GroupCount * BucketsPerGroup;
+
+    static unsigned bucketIndex(uint64_t ns);
+    // Midpoint of the bucket, as reported by fio
+    static uint64_t bucketValue(unsigned index);
+
+    void add(uint64_t ns, uint64_t count = 1);
+    void merge(const LatencyHistogram &other);
+    void clear();
+
+    bool isEmpty() const;
+    uint64_t count() const;
+    uint64_t bucket(unsigned index) const;
+
+    // Smallest bucket value that covers the given share of samples, 0 when empty
+    uint64_t percentile(double percent) const;
+
+private:
+    std::vector<uint64_t> m_buckets; // allocated on first use
+    uint64_t m_count = 0;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,29 @@
+#include "livechart.h"
+
+#include <QVBoxLayout>
+
+#include "chartwidget.h"
+
+LiveChart::LiveChart(QWidget *parent)
+    : QDialog(parent)
+    , m_chart(new ChartWidget(this))
+{
+    setWindowTitle(tr("Live Chart"));
+
+    m_chart->setAxisTitles(tr("Time (s)"), tr("MB/s"));
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(m_chart);
+}
+
+void LiveChart::addSample(const QString &series, unsigned int loop, double time, double bandwidth)
+{
+    // Keep the loops of one test together, start over with the next test
+    if (loop == 0 && series != m_lastSeries) {
+        m_chart->clear();
+    }
+
+    m_lastSeries = series;
+
+    m_chart->addPoint(series, time, bandwidth);
+}
@@ -0,0 +1,23 @@
+#ifndef LIVECHART_H
+#define LIVECHART_H
+
+#include <QDialog>
+
+class ChartWidget;
+
+class LiveChart : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit LiveChart(QWidget *parent = nullptr);
+
+public slots:
+    void addSample(const QString &series, unsigned int loop, double time, double bandwidth);
+
+private:
+    ChartWidget *m_chart;
+    QString m_lastSeries;
+};
+
+#endif // LIVECHART_H
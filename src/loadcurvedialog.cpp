@@ -0,0 +1,261 @@
+#include "loadcurvedialog.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QComboBox>
+#include <QFormLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QSpinBox>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "appsettings.h"
+#include "chartwidget.h"
+#include "global.h"
+
+namespace {
+// The curve bends once p99 grows beyond this multiple of its value at the lightest load
+constexpr double KneeFactor = 2;
+// A step counts as held while it reaches this share of the offered IOPS
+constexpr double HeldShare = 0.95;
+// Percentiles drawn on the chart, the table has all of Global::getLatencyPercentiles()
+const QVector<double> ChartPercentiles { 50, 99, 99.9 };
+}
+
+LoadCurveDialog::LoadCurveDialog(Benchmark *benchmark, QWidget *parent)
+    : ToolDialog(benchmark, parent)
+    , m_pattern(createPatternCombo())
+    , m_blockSize(createBlockSizeCombo())
+    , m_queueDepth(createQueueDepthCombo())
+    , m_threads(new QSpinBox(this))
+    , m_steps(new QSpinBox(this))
+    , m_arrivals(new QComboBox(this))
+    , m_chart(new ChartWidget(this))
+    , m_table(new QTreeWidget(this))
+    , m_summary(new QLabel(this))
+{
+    setWindowTitle(tr("Latency vs Load"));
+
+    m_threads->setRange(1, 64);
+
+    m_steps->setRange(2, 20);
+    m_steps->setValue(10);
+    m_steps->setToolTip(tr("The load grows in even steps up to 100% of the measured peak"));
+
+    m_arrivals->addItem(tr("Evenly spaced"), QStringLiteral("linear"));
+    m_arrivals->addItem(tr("Poisson"), QStringLiteral("poisson"));
+    m_arrivals->setToolTip(tr("Poisson arrivals come in bursts, like requests of many independent clients"));
+
+    m_chart->setAxisTitles(tr("IOPS"), tr("Latency, μs"));
+
+    QStringList headers { tr("Load"), tr("Offered IOPS"), tr("IOPS"), tr("MB/s"), tr("Mean μs") };
+    for (double percent : Global::getLatencyPercentiles()) {
+        headers << tr("p%1 μs").arg(percent);
+    }
+
+    m_table->setRootIsDecorated(false);
+    m_table->setHeaderLabels(headers);
+
+    m_summary->setWordWrap(true);
+
+    QFormLayout *formLayout = new QFormLayout;
+    formLayout->addRow(tr("Pattern:"), m_pattern);
+    formLayout->addRow(tr("Block size:"), m_blockSize);
+    formLayout->addRow(tr("Queue depth:"), m_queueDepth);
+    formLayout->addRow(tr("Threads:"), m_threads);
+    formLayout->addRow(tr("Steps:"), m_steps);
+    formLayout->addRow(tr("Arrivals:"), m_arrivals);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(formLayout);
+    layout->addWidget(m_chart, 1);
+    layout->addWidget(m_table);
+    layout->addWidget(m_summary);
+    layout->addLayout(createButtonLayout());
+
+    m_inputs = { m_pattern, m_blockSize, m_queueDepth, m_threads, m_steps, m_arrivals };
+}
+
+LoadCurveDialog::Point LoadCurveDialog::fromJob(const Benchmark::ParsedJob &job, double offered)
+{
+    // Reads and writes are added up, the offered load covers both
+    Point point;
+    point.offered = offered;
+    point.IOPS = job.read.IOPS + job.write.IOPS;
+    point.bandwidth = job.read.Bandwidth + job.write.Bandwidth;
+    point.latency = point.IOPS > 0 ? (job.read.Latency * job.read.IOPS + job.write.Latency * job.write.IOPS) / point.IOPS : 0;
+    point.histogram = job.read.Histogram;
+    point.histogram.merge(job.write.Histogram);
+
+    return point;
+}
+
+int LoadCurveDialog::kneeIndex() const
+{
+    if (m_points.isEmpty() || m_points.first().histogram.isEmpty()) return -1;
+
+    const uint64_t base = m_points.first().histogram.percentile(99);
+    int knee = 0;
+
+    for (int i = 1; i < m_points.size(); i++) {
+        if (m_points.at(i).histogram.percentile(99) > base * KneeFactor) break;
+        knee = i;
+    }
+
+    return knee;
+}
+
+void LoadCurveDialog::updateResults()
+{
+    m_table->clear();
+    m_chart->clear();
+
+    QVector<Point> rows = m_points;
+    if (m_hasPeak) rows << m_peak;
+
+    for (int i = 0; i < rows.size(); i++) {
+        const Point &point = rows.at(i);
+        const bool unlimited = point.offered <= 0;
+
+        QStringList columns {
+            unlimited ? tr("Unlimited") : QStringLiteral("%1%").arg(m_percents.at(i)),
+            unlimited ? QStringLiteral("–") : QString::number(point.offered, 'f', 0),
+            QString::number(point.IOPS, 'f', 0),
+            QString::number(point.bandwidth, 'f', 1),
+            QString::number(point.latency, 'f', 1)
+        };
+
+        for (double percent : Global::getLatencyPercentiles()) {
+            columns << QString::number(point.histogram.percentile(percent) / 1000.0, 'f', 1);
+        }
+
+        QTreeWidgetItem *item = new QTreeWidgetItem(columns);
+        if (!unlimited && point.IOPS < point.offered * HeldShare) item->setForeground(2, Qt::red);
+        m_table->addTopLevelItem(item);
+
+        for (double percent : ChartPercentiles) {
+            m_chart->addPoint(tr("p%1").arg(percent), point.IOPS, point.histogram.percentile(percent) / 1000.0);
+        }
+    }
+
+    for (int i = 0; i < m_table->columnCount(); i++) {
+        m_table->resizeColumnToContents(i);
+    }
+
+    int knee = kneeIndex();
+
+    if (knee < 0) {
+        m_summary->clear();
+    }
+    else if (knee == m_points.size() - 1 && m_points.size() == m_percents.size()) {
+        m_summary->setText(tr("p99 stays within %1× of its light load value at every step, up to %2 IOPS.")
+                           .arg(KneeFactor).arg(m_points.at(knee).IOPS, 0, 'f', 0));
+    }
+    else if (knee < m_points.size() - 1) {
+        const Point &point = m_points.at(knee);
+        m_summary->setText(tr("p99 stays within %1× of its light load value up to %2 IOPS, %3% of the %4 IOPS peak, "
+                              "with a p99 of %5 μs there.")
+                           .arg(KneeFactor).arg(point.IOPS, 0, 'f', 0).arg(m_percents.at(knee)).arg(m_peak.IOPS, 0, 'f', 0)
+                           .arg(point.histogram.percentile(99) / 1000.0, 0, 'f', 1));
+    }
+    else {
+        m_summary->clear();
+    }
+}
+
+bool LoadCurveDialog::prepareRun()
+{
+    // Every step after the peak measurement is a rate limited test
+    if (AppSettings().getBenchmarkEngine() == Global::BenchmarkEngine::NativeIOUring) {
+        QMessageBox::critical(this, tr("Not available"), tr("The native io_uring engine cannot limit the rate of a test. Choose another engine."));
+        return false;
+    }
+
+    m_percents.clear();
+    m_points.clear();
+    m_hasPeak = false;
+
+    for (int i = 1; i <= m_steps->value(); i++) {
+        m_percents << 100 * i / m_steps->value();
+    }
+
+    updateResults();
+
+    return true;
+}
+
+bool LoadCurveDialog::run()
+{
+    // Taken once, so the rate split and the job agree on the mix
+    Benchmark::TestSpec spec { m_pattern->currentData().toString(), m_blockSize->currentData().toInt(),
+                               m_queueDepth->currentData().toInt(), m_threads->value(), {} };
+    spec.readPercentage = AppSettings().getRandomReadPercentage();
+
+    const QString arrivals = m_arrivals->currentData().toString();
+    const int total = m_percents.size() + 1;
+
+    m_status->setText(tr("Measuring the peak, about %1 left").arg(Global::formatDuration(AppSettings().getMeasuringTime() * 1000 * total)));
+
+    Benchmark::ParsedJob job;
+    if (!m_benchmark->measure(spec, job, tr("Latency vs Load peak (1/%1)").arg(total))) return false;
+
+    m_peak = fromJob(job, 0);
+    m_hasPeak = true;
+    updateResults();
+
+    if (m_peak.IOPS <= 0) return false;
+
+    for (int i = 0; i < m_percents.size(); i++) {
+        updateEta(i + 1, total);
+
+        const double offered = m_peak.IOPS * m_percents.at(i) / 100;
+
+        Benchmark::TestSpec step = spec;
+        step.options["rate_iops"] = m_benchmark->rateIOPS(spec.rw, spec.readPercentage, spec.threads, offered);
+        step.options["rate_process"] = arrivals;
+
+        if (!m_benchmark->measure(step, job, tr("Latency vs Load %1% (%2/%3)").arg(m_percents.at(i)).arg(i + 2).arg(total))) return false;
+
+        m_points.append(fromJob(job, offered));
+
+        updateResults();
+    }
+
+    return true;
+}
+
+bool LoadCurveDialog::hasResults() const
+{
+    return m_hasPeak;
+}
+
+void LoadCurveDialog::copyResults()
+{
+    QString header = QStringLiteral("load_percent,offered_iops,iops,mb_s,mean_us");
+    for (double percent : Global::getLatencyPercentiles()) {
+        header += QStringLiteral(",p%1_us").arg(percent);
+    }
+
+    QStringList lines { header };
+
+    QVector<Point> rows = m_points;
+    if (m_hasPeak) rows << m_peak;
+
+    for (int i = 0; i < rows.size(); i++) {
+        const Point &point = rows.at(i);
+        const bool unlimited = point.offered <= 0;
+
+        QString line = QStringLiteral("%1,%2,%3,%4,%5").arg(unlimited ? QString() : QString::number(m_percents.at(i)))
+                       .arg(unlimited ? QString() : QString::number(point.offered, 'f', 3))
+                       .arg(point.IOPS, 0, 'f', 3).arg(point.bandwidth, 0, 'f', 3).arg(point.latency, 0, 'f', 3);
+
+        for (double percent : Global::getLatencyPercentiles()) {
+            line += QStringLiteral(",%1").arg(point.histogram.percentile(percent) / 1000.0, 0, 'f', 3);
+        }
+
+        lines << line;
+    }
+
+    QApplication::clipboard()->setText(lines.join('\n'));
+}
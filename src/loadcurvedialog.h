@@ -0,0 +1,60 @@
+#ifndef LOADCURVEDIALOG_H
+#define LOADCURVEDIALOG_H
+
+#include <QVector>
+
+#include "latencyhistogram.h"
+#include "tooldialog.h"
+
+class QComboBox;
+class QLabel;
+class QSpinBox;
+class QTreeWidget;
+class ChartWidget;
+
+// Measures the peak IOPS of a job, then offers it a growing share of that peak with rate_iops
+// and records the latency percentiles at every step, giving a latency versus throughput curve
+class LoadCurveDialog : public ToolDialog
+{
+    Q_OBJECT
+
+public:
+    explicit LoadCurveDialog(Benchmark *benchmark, QWidget *parent = nullptr);
+
+private:
+    struct Point
+    {
+        double offered = 0; // IOPS, 0 for the unlimited run
+        double IOPS = 0;
+        double bandwidth = 0;
+        double latency = 0; // mean, μs
+        LatencyHistogram histogram;
+    };
+
+    static Point fromJob(const Benchmark::ParsedJob &job, double offered);
+    // Last step whose p99 stays within KneeFactor of the lightest step's p99, -1 if none
+    int kneeIndex() const;
+    void updateResults();
+
+    bool prepareRun() override;
+    bool run() override;
+    bool hasResults() const override;
+    void copyResults() override;
+
+    QComboBox *m_pattern;
+    QComboBox *m_blockSize;
+    QComboBox *m_queueDepth;
+    QSpinBox *m_threads;
+    QSpinBox *m_steps;
+    QComboBox *m_arrivals;
+    ChartWidget *m_chart;
+    QTreeWidget *m_table;
+    QLabel *m_summary;
+
+    bool m_hasPeak = false;
+    Point m_peak;
+    QVector<int> m_percents;
+    QVector<Point> m_points;
+};
+
+#endif // LOADCURVEDIALOG_H
@@ -12,9 +12,24 @@
 #include <QStyleFactory>
 #include <QTimer>
 #include <QActionGroup>
+#include <QMenu>
+#include <QInputDialog>
 
 #include "math.h"
 #include "about.h"
+#include "livechart.h"
+#include "sweepdialog.h"
+#include "threadscalingdialog.h"
+#include "loadcurvedialog.h"
+#include "numadialog.h"
+#include "workloadsdialog.h"
+#include "workloadlibrarydialog.h"
+#include "tracedialog.h"
+#include "commitlatencydialog.h"
+#include "metadatadialog.h"
+#include "smallfilesdialog.h"
+#include "targetsdialog.h"
+#include "histogramwidget.h"
 #include "settings.h"
 #include "diskdriveinfo.h"
 #include "storageitemdelegate.h"
@@ -78,6 +93,8 @@ MainWindow::MainWindow(QWidget *parent)
     ui->actionPeak_Performance->setProperty("mixed", false);
     ui->actionReal_World_Performance->setProperty("profile", Global::PerformanceProfile::RealWorld);
     ui->actionReal_World_Performance->setProperty("mixed", false);
+    ui->actionSteady_State_Performance->setProperty("profile", Global::PerformanceProfile::SteadyState);
+    ui->actionSteady_State_Performance->setProperty("mixed", false);
     ui->actionDemo->setProperty("profile", Global::PerformanceProfile::Demo);
     ui->actionDemo->setProperty("mixed", false);
     ui->actionDefault_Mix->setProperty("profile", Global::PerformanceProfile::Default);
@@ -86,15 +103,19 @@ MainWindow::MainWindow(QWidget *parent)
     ui->actionPeak_Performance_Mix->setProperty("mixed", true);
     ui->actionReal_World_Performance_Mix->setProperty("profile", Global::PerformanceProfile::RealWorld);
     ui->actionReal_World_Performance_Mix->setProperty("mixed", true);
+    ui->actionSteady_State_Performance_Mix->setProperty("profile", Global::PerformanceProfile::SteadyState);
+    ui->actionSteady_State_Performance_Mix->setProperty("mixed", true);
 
     QActionGroup *profilesGroup = new QActionGroup(this);
     ui->actionDefault->setActionGroup(profilesGroup);
     ui->actionPeak_Performance->setActionGroup(profilesGroup);
     ui->actionReal_World_Performance->setActionGroup(profilesGroup);
+    ui->actionSteady_State_Performance->setActionGroup(profilesGroup);
     ui->actionDemo->setActionGroup(profilesGroup);
     ui->actionDefault_Mix->setActionGroup(profilesGroup);
     ui->actionPeak_Performance_Mix->setActionGroup(profilesGroup);
     ui->actionReal_World_Performance_Mix->setActionGroup(profilesGroup);
+    ui->actionSteady_State_Performance_Mix->setActionGroup(profilesGroup);
     connect(profilesGroup, SIGNAL(triggered(QAction*)), this, SLOT(profileSelected(QAction*)));
 
     ui->actionRead_Write_Mix->setProperty("mode", Global::BenchmarkMode::ReadWriteMix);
@@ -109,12 +130,36 @@ MainWindow::MainWindow(QWidget *parent)
 
     ui->actionTestData_Random->setProperty("data", Global::BenchmarkTestData::Random);
     ui->actionTestData_Zeros->setProperty("data", Global::BenchmarkTestData::Zeros);
+    ui->actionTestData_Compressible->setProperty("data", Global::BenchmarkTestData::Compressible);
 
     QActionGroup *testDataGroup = new QActionGroup(this);
     ui->actionTestData_Random->setActionGroup(testDataGroup);
     ui->actionTestData_Zeros->setActionGroup(testDataGroup);
+    ui->actionTestData_Compressible->setActionGroup(testDataGroup);
     connect(testDataGroup, SIGNAL(triggered(QAction*)), this, SLOT(testDataSelected(QAction*)));
 
+    ui->actionEngine_FIO->setProperty("engine", Global::BenchmarkEngine::FIO);
+    ui->actionEngine_FIOServer->setProperty("engine", Global::BenchmarkEngine::FIOServer);
+    ui->actionEngine_Native->setProperty("engine", Global::BenchmarkEngine::NativeIOUring);
+
+    QActionGroup *engineGroup = new QActionGroup(this);
+    ui->actionEngine_FIO->setActionGroup(engineGroup);
+    ui->actionEngine_FIOServer->setActionGroup(engineGroup);
+    ui->actionEngine_Native->setActionGroup(engineGroup);
+    connect(engineGroup, SIGNAL(triggered(QAction*)), this, SLOT(engineSelected(QAction*)));
+
+    ui->actionPrecondition_Off->setProperty("passes", 0);
+    ui->actionPrecondition_1->setProperty("passes", 1);
+    ui->actionPrecondition_2->setProperty("passes", 2);
+    ui->actionPrecondition_4->setProperty("passes", 4);
+
+    QActionGroup *preconditionGroup = new QActionGroup(this);
+    ui->actionPrecondition_Off->setActionGroup(preconditionGroup);
+    ui->actionPrecondition_1->setActionGroup(preconditionGroup);
+    ui->actionPrecondition_2->setActionGroup(preconditionGroup);
+    ui->actionPrecondition_4->setActionGroup(preconditionGroup);
+    connect(preconditionGroup, SIGNAL(triggered(QAction*)), this, SLOT(preconditionSelected(QAction*)));
+
     ui->actionPreset_Standard->setProperty("preset", Global::BenchmarkPreset::Standard);
     ui->actionPreset_NVMe_SSD->setProperty("preset", Global::BenchmarkPreset::NVMe_SSD);
 
@@ -141,13 +186,33 @@ MainWindow::MainWindow(QWidget *parent)
                    << ui->readBar_4 << ui->writeBar_4 << ui->mixBar_4
                    << ui->readBar_Demo << ui->writeBar_Demo;
 
+    QVector<QPushButton*> testButtons = { ui->pushButton_Test_1, ui->pushButton_Test_2, ui->pushButton_Test_3, ui->pushButton_Test_4 };
+
+    for (int i = 0; i < m_progressBars.size(); i++) {
+        QProgressBar *progressBar = m_progressBars[i];
+        QPushButton *testButton = i < testButtons.size() * 3 ? testButtons[i / 3] : ui->pushButton_Test_1;
+
+        progressBar->setContextMenuPolicy(Qt::CustomContextMenu);
+        connect(progressBar, &QProgressBar::customContextMenuRequested, this, [=] (const QPoint &pos) {
+            QMenu menu;
+            QAction *histogramAction = menu.addAction(tr("Latency Histogram"));
+            histogramAction->setEnabled(!progressBar->property("Histogram").value<LatencyHistogram>().isEmpty());
+
+            if (menu.exec(progressBar->mapToGlobal(pos)) == histogramAction) {
+                const QStringList directions = { tr("Read"), tr("Write"), tr("Mix") };
+                showLatencyHistogram(progressBar, QStringLiteral("%1 %2").arg(testButton->text().simplified(), directions[i % 3]));
+            }
+        });
+    }
+
     refreshProgressBars();
 
     // Load settings
     const AppSettings settings;
 
-    for (QAction *action : { ui->actionDefault, ui->actionPeak_Performance, ui->actionReal_World_Performance, ui->actionDemo,
-                             ui->actionDefault_Mix, ui->actionPeak_Performance_Mix, ui->actionReal_World_Performance_Mix }) {
+    for (QAction *action : { ui->actionDefault, ui->actionPeak_Performance, ui->actionReal_World_Performance, ui->actionSteady_State_Performance,
+                             ui->actionDemo, ui->actionDefault_Mix, ui->actionPeak_Performance_Mix, ui->actionReal_World_Performance_Mix,
+                             ui->actionSteady_State_Performance_Mix }) {
         if (action->property("profile").toInt() == settings.getPerformanceProfile() && action->property("mixed").toBool() == settings.getMixedState()) {
             action->setChecked(true);
             profileSelected(action);
@@ -165,13 +230,20 @@ MainWindow::MainWindow(QWidget *parent)
     ui->comboBox_MixRatio->setCurrentIndex(indexMixRatio);
 
     ui->actionTestData_Zeros->setChecked(settings.getBenchmarkTestData() == Global::BenchmarkTestData::Zeros);
+    ui->actionTestData_Compressible->setChecked(settings.getBenchmarkTestData() == Global::BenchmarkTestData::Compressible);
     ui->actionTestData_Continuous->setChecked(settings.getContinuousGenerationState());
+    ui->actionEngine_FIOServer->setChecked(settings.getBenchmarkEngine() == Global::BenchmarkEngine::FIOServer);
+    ui->actionEngine_Native->setChecked(settings.getBenchmarkEngine() == Global::BenchmarkEngine::NativeIOUring);
+    for (QAction *action : preconditionGroup->actions()) {
+        action->setChecked(action->property("passes").toInt() == settings.getPreconditionPasses());
+    }
     ui->actionRead_Mix->setChecked(settings.getBenchmarkMode() == Global::BenchmarkMode::ReadMix);
     ui->actionWrite_Mix->setChecked(settings.getBenchmarkMode() == Global::BenchmarkMode::WriteMix);
 
     ui->actionUse_O_DIRECT->setChecked(settings.getCacheBypassState());
     ui->actionFlush_Pagecache->setChecked(settings.getFlusingCacheState());
     ui->actionCoW_detection->setChecked(settings.getCoWDetectionState());
+    ui->actionKeep_Benchmark_File->setChecked(settings.getKeepBenchmarkFileState());
     ui->loopsCount->setValue(settings.getLoopsCount());
 
     ui->actionTheme_Stylesheet_Light->setChecked(settings.getTheme() == Global::Theme::StyleSheetLight);
@@ -231,18 +303,8 @@ void MainWindow::changeEvent(QEvent *event)
         updateBenchmarkButtonsContent();
         updateLabels();
 
-        QMetaEnum metaEnum = QMetaEnum::fromType<Global::ComparisonUnit>();
-
-        QLocale locale = QLocale();
-
         for (auto const& progressBar: m_progressBars) {
-            if (!progressBar->property("Demo").toBool())
-                progressBar->setToolTip(
-                    Global::getToolTipTemplate().arg(
-                        locale.toString(progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::MBPerSec)).toFloat(), 'f', 3),
-                        locale.toString(progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::GBPerSec)).toFloat(), 'f', 3),
-                        locale.toString(progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::IOPS)).toFloat(), 'f', 3),
-                        locale.toString(progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::Latency)).toFloat(), 'f', 3)));
+            updateToolTip(progressBar);
             updateProgressBar(progressBar);
         }
 
@@ -253,9 +315,7 @@ void MainWindow::changeEvent(QEvent *event)
 
                 storage.formatedSize = formatSize(storage.bytesOccupied, storage.bytesTotal);
 
-                ui->comboBox_Storages->setItemText(i, QStringLiteral("%1 %2% (%3)").arg(storage.path)
-                                                   .arg(storage.bytesOccupied * 100 / storage.bytesTotal)
-                                                   .arg(storage.formatedSize));
+                ui->comboBox_Storages->setItemText(i, storageItemText(storage));
 
                 ui->comboBox_Storages->setItemData(i, QVariant::fromValue(storage));
             }
@@ -333,12 +393,18 @@ void MainWindow::addItemToStoragesList(const Global::Storage &storage)
     if (ui->comboBox_Storages->findText(storage.path, Qt::MatchContains) != -1)
          return;
 
-    ui->comboBox_Storages->addItem(
-                QStringLiteral("%1 %2% (%3)").arg(storage.path)
-                .arg(storage.bytesOccupied * 100 / storage.bytesTotal)
-                .arg(storage.formatedSize),
-                QVariant::fromValue(storage)
-                );
+    ui->comboBox_Storages->addItem(storageItemText(storage), QVariant::fromValue(storage));
+}
+
+QString MainWindow::storageItemText(const Global::Storage &storage)
+{
+    if (storage.rawDevice) {
+        return tr("%1 [raw, read-only] (%2)").arg(storage.path, storage.formatedSize.section('/', 1));
+    }
+
+    return QStringLiteral("%1 %2% (%3)").arg(storage.path)
+           .arg(storage.bytesOccupied * 100 / storage.bytesTotal)
+           .arg(storage.formatedSize);
 }
 
 void MainWindow::updateFileSizeList()
@@ -410,6 +476,11 @@ void MainWindow::on_actionCoW_detection_triggered(bool checked)
     AppSettings().setCoWDetectionState(checked);
 }
 
+void MainWindow::on_actionKeep_Benchmark_File_triggered(bool checked)
+{
+    AppSettings().setKeepBenchmarkFileState(checked);
+}
+
 void MainWindow::updateBenchmarkButtonsContent()
 {
     const AppSettings settings;
@@ -438,6 +509,7 @@ void MainWindow::updateBenchmarkButtonsContent()
         break;
     case Global::PerformanceProfile::Peak:
     case Global::PerformanceProfile::RealWorld:
+    case Global::PerformanceProfile::SteadyState:
         ui->pushButton_Test_1->setToolTip(Global::getBenchmarkButtonToolTip(params, true).arg(tr("MB/s")));
 
         params = settings.getBenchmarkParams(Global::BenchmarkTest::Test_2, settings.getPerformanceProfile());
@@ -506,17 +578,13 @@ void MainWindow::refreshProgressBars()
         progressBar->setProperty(metaEnum.valueToKey(Global::ComparisonUnit::GBPerSec), 0);
         progressBar->setProperty(metaEnum.valueToKey(Global::ComparisonUnit::IOPS), 0);
         progressBar->setProperty(metaEnum.valueToKey(Global::ComparisonUnit::Latency), 0);
+        progressBar->setProperty(metaEnum.valueToKey(Global::ComparisonUnit::SLOIOPS), 0);
+        progressBar->setProperty("Histogram", QVariant());
+        progressBar->setProperty("Samples", QVariant());
+        progressBar->setProperty("SteadyStateTime", 0);
         progressBar->setValue(0);
         progressBar->setFormat(locale.toString(0., 'f', progressBar->property("Demo").toBool() ? 1 : 2));
-        if (!progressBar->property("Demo").toBool())
-        progressBar->setToolTip(
-                    Global::getToolTipTemplate().arg(
-                        locale.toString(0., 'f', 3),
-                        locale.toString(0., 'f', 3),
-                        locale.toString(0., 'f', 3),
-                        locale.toString(0., 'f', 3)
-                        )
-                    );
+        updateToolTip(progressBar);
     }
 }
 
@@ -565,7 +633,7 @@ QString MainWindow::combineOutputTestResult(const QProgressBar *progressBar, con
 {
     QMetaEnum metaEnum = QMetaEnum::fromType<Global::ComparisonUnit>();
 
-    return QStringLiteral("%1 %2 %3 (Q=%4, T=%5): %6 MB/s [ %7 IOPS] < %8 us>")
+    QString result = QStringLiteral("%1 %2 %3 (Q=%4, T=%5): %6 MB/s [ %7 IOPS] < %8 us>")
            .arg(params.Pattern == Global::BenchmarkIOPattern::SEQ ? "Sequential" : "Random")
            .arg(QString::number(params.BlockSize >= 1024 ? params.BlockSize / 1024 : params.BlockSize).rightJustified(3, ' '))
            .arg(params.BlockSize >= 1024 ? "MiB" : "KiB")
@@ -581,6 +649,72 @@ QString MainWindow::combineOutputTestResult(const QProgressBar *progressBar, con
                     progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::Latency)).toFloat(), 'f', 2)
                 .rightJustified(8, ' '))
            .rightJustified(Global::getOutputColumnsCount(), ' ');
+
+    LatencyHistogram histogram = progressBar->property("Histogram").value<LatencyHistogram>();
+
+    if (!histogram.isEmpty()) {
+        QStringList percentiles;
+        for (double percent : Global::getLatencyPercentiles()) {
+            percentiles << QStringLiteral("p%1=%2").arg(percent).arg(histogram.percentile(percent) / 1000., 0, 'f', 2);
+        }
+        result += QStringLiteral("\n") + QStringLiteral("{%1} us").arg(percentiles.join(", "))
+                  .rightJustified(Global::getOutputColumnsCount(), ' ');
+    }
+
+    const AppSettings settings;
+
+    if (settings.getComparisonUnit() == Global::ComparisonUnit::SLOIOPS) {
+        result += QStringLiteral("\n") + QStringLiteral("[SLO: %1 IOPS with p%2 <= %3 us]")
+                  .arg(progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::SLOIOPS)).toFloat(), 0, 'f', 1)
+                  .arg(settings.getSLOPercentile()).arg(settings.getSLOLatency())
+                  .rightJustified(Global::getOutputColumnsCount(), ' ');
+    }
+
+    float steadyStateTime = progressBar->property("SteadyStateTime").toFloat();
+
+    if (steadyStateTime != 0) {
+        result += QStringLiteral("\n") + (steadyStateTime > 0 ? QStringLiteral("[steady state after %1 s]")
+                                                               : QStringLiteral("[steady state not reached in %1 s]"))
+                  .arg(qAbs(steadyStateTime), 0, 'f', 0)
+                  .rightJustified(Global::getOutputColumnsCount(), ' ');
+    }
+
+    QVector<Benchmark::Sample> targets = progressBar->property("Targets").value<QVector<Benchmark::Sample>>();
+
+    if (targets.size() > 1) {
+        const QStringList dirs = QStringList(m_benchmark->getBenchmarkFile()) + m_benchmark->getExtraDirs();
+
+        for (int i = 0; i < targets.size(); i++) {
+            result += QStringLiteral("\n") + QStringLiteral("%1: %2 MB/s [ %3 IOPS] < %4 us>")
+                      .arg(i < dirs.size() ? dirs.at(i) : QString::number(i + 1))
+                      .arg(QString::number(targets.at(i).Bandwidth, 'f', 3).rightJustified(9, ' '))
+                      .arg(QString::number(targets.at(i).IOPS, 'f', 1).rightJustified(8, ' '))
+                      .arg(QString::number(targets.at(i).Latency, 'f', 2).rightJustified(8, ' '))
+                      .rightJustified(Global::getOutputColumnsCount(), ' ');
+        }
+    }
+
+    QVector<Benchmark::Sample> samples = progressBar->property("Samples").value<QVector<Benchmark::Sample>>();
+
+    if (samples.size() > 1) {
+        const QVector<QPair<QString, float Benchmark::Sample::*>> fields = {
+            { "MB/s", &Benchmark::Sample::Bandwidth },
+            { "IOPS", &Benchmark::Sample::IOPS },
+            { "us", &Benchmark::Sample::Latency }
+        };
+
+        for (const auto &field : fields) {
+            Statistics::Summary summary = Benchmark::summarize(samples, field.second);
+            result += QStringLiteral("\n") + QStringLiteral("%1 [n=%2]: %3 +/- %4, median %5, min %6, max %7, sd %8")
+                      .arg(field.first).arg(summary.count)
+                      .arg(summary.mean, 0, 'f', 3).arg(summary.ci95, 0, 'f', 3)
+                      .arg(summary.median, 0, 'f', 3).arg(summary.min, 0, 'f', 3)
+                      .arg(summary.max, 0, 'f', 3).arg(summary.stddev, 0, 'f', 3)
+                      .rightJustified(Global::getOutputColumnsCount(), ' ');
+        }
+    }
+
+    return result;
 }
 
 QString MainWindow::getTextBenchmarkResult()
@@ -640,7 +774,7 @@ QString MainWindow::getTextBenchmarkResult()
              }
     }
 
-    QString profiles[] = { "Default", "Peak Performance", "Real World Performance", "Demo" };
+    QString profiles[] = { "Default", "Peak Performance", "Real World Performance", "Demo", "Steady State Performance" };
 
     output << QString()
            << QStringLiteral("Profile: %1%2")
@@ -649,17 +783,34 @@ QString MainWindow::getTextBenchmarkResult()
               .arg("%1 %2 (x%3) [Measure: %4 %5 / Interval: %6 %7]")
               .arg(settings.getFileSize() >= 1024 ? settings.getFileSize() / 1024 : settings.getFileSize())
               .arg(settings.getFileSize() >= 1024 ? "GiB" : "MiB")
-              .arg(settings.getLoopsCount())
+              .arg(settings.getAdaptiveTargetCI() > 0
+                   ? QStringLiteral("%1 max, adaptive +/-%2%").arg(settings.getAdaptiveMaxLoops()).arg(settings.getAdaptiveTargetCI())
+                   : QString::number(settings.getLoopsCount()))
               .arg(settings.getMeasuringTime() >= 60 ? settings.getMeasuringTime() / 60 : settings.getMeasuringTime())
               .arg(settings.getMeasuringTime() >= 60 ? "min" : "sec")
               .arg(settings.getIntervalTime() >= 60 ? settings.getIntervalTime() / 60 : settings.getIntervalTime())
               .arg(settings.getIntervalTime() >= 60 ? "min" : "sec")
+           << QStringLiteral("Precond: %1")
+              .arg(settings.getPreconditionPasses() > 0
+                   ? QStringLiteral("%1x sequential fill + %1x random 4KiB overwrite").arg(settings.getPreconditionPasses())
+                   : QStringLiteral("none"))
+           << QStringLiteral("   Data: %1")
+              .arg(settings.getBenchmarkTestData() == Global::BenchmarkTestData::Zeros ? QStringLiteral("zeros")
+                   : settings.getBenchmarkTestData() == Global::BenchmarkTestData::Random ? QStringLiteral("random")
+                   : QStringLiteral("compressible %1% (%2:1), dedupe %3%")
+                     .arg(settings.getCompressPercentage())
+                     .arg(100. / (100 - qMin(settings.getCompressPercentage(), 99)), 0, 'f', 1)
+                     .arg(settings.getDedupePercentage()))
            << QStringLiteral("   Date: %1 %2")
               .arg(QDate::currentDate().toString("yyyy-MM-dd"))
               .arg(QTime::currentTime().toString("hh:mm:ss"))
            << QStringLiteral("     OS: %1 %2 [%3 %4]").arg(QSysInfo::productType()).arg(QSysInfo::productVersion())
               .arg(QSysInfo::kernelType()).arg(QSysInfo::kernelVersion());
 
+    if (settings.getComparisonUnit() == Global::ComparisonUnit::SLOIOPS) {
+        output << QStringLiteral("    SLO: p%1 <= %2 us").arg(settings.getSLOPercentile()).arg(settings.getSLOLatency());
+    }
+
     QString targetInfo = ui->comboBox_Storages->currentText();
     QString modelName = ui->deviceModel->text();
     if (!modelName.isEmpty()) {
@@ -669,6 +820,10 @@ QString MainWindow::getTextBenchmarkResult()
     output << QString(" Target: %1")
               .arg(targetInfo);
 
+    for (const QString &dir : m_benchmark->getExtraDirs()) {
+        output << QString("       + %1").arg(dir);
+    }
+
     return output.join("\n");
 }
 
@@ -746,8 +901,20 @@ void MainWindow::on_comboBox_Storages_currentIndexChanged(int index)
         if (variant.canConvert<Global::Storage>()) {
             Global::Storage volumeInfo = variant.value<Global::Storage>();
             m_benchmark->setDir(volumeInfo.path);
-            ui->deviceModel->setText(DiskDriveInfo::Instance().getModelName(QStorageInfo(volumeInfo.path).device()));
-            ui->extraIcon->setVisible(DiskDriveInfo::Instance().isEncrypted(QStorageInfo(volumeInfo.path).device()));
+            // A raw device is benchmarked alone, so the other targets are dropped rather than silently ignored
+            if (volumeInfo.rawDevice || m_benchmark->getExtraDirs().contains(volumeInfo.path)) {
+                QStringList extraDirs = m_benchmark->getExtraDirs();
+                if (volumeInfo.rawDevice) extraDirs.clear();
+                else extraDirs.removeAll(volumeInfo.path);
+                m_benchmark->setExtraDirs(extraDirs);
+            }
+            ui->actionAdditional_Targets->setEnabled(!volumeInfo.rawDevice);
+            updateExtraTargetsAction();
+            const QString device = volumeInfo.rawDevice ? volumeInfo.path : QString(QStorageInfo(volumeInfo.path).device());
+            ui->deviceModel->setText(DiskDriveInfo::Instance().getModelName(device));
+            int numaNode = DiskDriveInfo::Instance().getNumaNode(device);
+            ui->deviceModel->setToolTip(numaNode >= 0 ? tr("NUMA node %1").arg(numaNode) : QString());
+            ui->extraIcon->setVisible(DiskDriveInfo::Instance().isEncrypted(device));
         }
     }
 }
@@ -788,6 +955,11 @@ void MainWindow::profileSelected(QAction* act)
         ui->comboBox_ComparisonUnit->setCurrentIndex(0);
         ui->comboBox_ComparisonUnit->setVisible(false);
         break;
+    case Global::PerformanceProfile::SteadyState:
+        m_windowTitle = "KDiskMark <STEADY>";
+        ui->comboBox_ComparisonUnit->setCurrentIndex(0);
+        ui->comboBox_ComparisonUnit->setVisible(false);
+        break;
     case Global::PerformanceProfile::Demo:
         m_windowTitle = "KDiskMark <DEMO>";
         ui->comboBox_ComparisonUnit->setVisible(true);
@@ -823,6 +995,16 @@ void MainWindow::testDataSelected(QAction* act)
     AppSettings().setBenchmarkTestData((Global::BenchmarkTestData)act->property("data").toInt());
 }
 
+void MainWindow::engineSelected(QAction* act)
+{
+    AppSettings().setBenchmarkEngine((Global::BenchmarkEngine)act->property("engine").toInt());
+}
+
+void MainWindow::preconditionSelected(QAction* act)
+{
+    AppSettings().setPreconditionPasses(act->property("passes").toInt());
+}
+
 void MainWindow::presetSelected(QAction* act)
 {
     AppSettings settings;
@@ -931,6 +1113,209 @@ void MainWindow::on_actionAbout_triggered()
     about.exec();
 }
 
+void MainWindow::on_actionLive_Chart_triggered()
+{
+    if (!m_liveChart) {
+        m_liveChart = new LiveChart(this);
+        connect(m_benchmark, &Benchmark::liveSampleReady, m_liveChart, &LiveChart::addSample);
+    }
+
+    m_liveChart->show();
+    m_liveChart->raise();
+    m_liveChart->activateWindow();
+}
+
+void MainWindow::on_actionQueue_Depth_Block_Size_Sweep_triggered()
+{
+    if (!m_sweepDialog) {
+        m_sweepDialog = new SweepDialog(m_benchmark, this);
+    }
+
+    m_sweepDialog->show();
+    m_sweepDialog->raise();
+    m_sweepDialog->activateWindow();
+}
+
+void MainWindow::on_actionThread_Scaling_triggered()
+{
+    if (!m_threadScalingDialog) {
+        m_threadScalingDialog = new ThreadScalingDialog(m_benchmark, this);
+    }
+
+    m_threadScalingDialog->show();
+    m_threadScalingDialog->raise();
+    m_threadScalingDialog->activateWindow();
+}
+
+void MainWindow::on_actionLatency_vs_Load_triggered()
+{
+    if (!m_loadCurveDialog) {
+        m_loadCurveDialog = new LoadCurveDialog(m_benchmark, this);
+    }
+
+    m_loadCurveDialog->show();
+    m_loadCurveDialog->raise();
+    m_loadCurveDialog->activateWindow();
+}
+
+void MainWindow::on_actionNUMA_Placement_triggered()
+{
+    if (!m_numaDialog) {
+        m_numaDialog = new NumaDialog(m_benchmark, this);
+    }
+
+    m_numaDialog->show();
+    m_numaDialog->raise();
+    m_numaDialog->activateWindow();
+}
+
+void MainWindow::on_actionCustom_Workloads_triggered()
+{
+    if (!m_workloadsDialog) {
+        m_workloadsDialog = new WorkloadsDialog(m_benchmark, this);
+    }
+
+    m_workloadsDialog->show();
+    m_workloadsDialog->raise();
+    m_workloadsDialog->activateWindow();
+}
+
+void MainWindow::on_actionWorkload_Library_triggered()
+{
+    if (!m_workloadLibraryDialog) {
+        m_workloadLibraryDialog = new WorkloadLibraryDialog(m_benchmark, this);
+    }
+
+    m_workloadLibraryDialog->show();
+    m_workloadLibraryDialog->raise();
+    m_workloadLibraryDialog->activateWindow();
+}
+
+void MainWindow::on_actionTrace_Replay_triggered()
+{
+    if (!m_traceDialog) {
+        m_traceDialog = new TraceDialog(m_benchmark, this);
+    }
+
+    m_traceDialog->show();
+    m_traceDialog->raise();
+    m_traceDialog->activateWindow();
+}
+
+void MainWindow::on_actionCommit_Latency_triggered()
+{
+    if (!m_commitLatencyDialog) {
+        m_commitLatencyDialog = new CommitLatencyDialog(m_benchmark, this);
+    }
+
+    m_commitLatencyDialog->show();
+    m_commitLatencyDialog->raise();
+    m_commitLatencyDialog->activateWindow();
+}
+
+void MainWindow::on_actionMetadata_Operations_triggered()
+{
+    if (!m_metadataDialog) {
+        m_metadataDialog = new MetadataDialog(m_benchmark, this);
+    }
+
+    m_metadataDialog->show();
+    m_metadataDialog->raise();
+    m_metadataDialog->activateWindow();
+}
+
+void MainWindow::on_actionSmall_Files_triggered()
+{
+    if (!m_smallFilesDialog) {
+        m_smallFilesDialog = new SmallFilesDialog(m_benchmark, this);
+    }
+
+    m_smallFilesDialog->show();
+    m_smallFilesDialog->raise();
+    m_smallFilesDialog->activateWindow();
+}
+
+void MainWindow::on_actionAdd_Raw_Block_Device_triggered()
+{
+    QStringList devices;
+
+    const QStringList entries = QDir(QStringLiteral("/sys/block")).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &entry : entries) {
+        QFile sizeFile(QStringLiteral("/sys/block/%1/size").arg(entry));
+        if (!sizeFile.open(QIODevice::ReadOnly | QIODevice::Text)) continue;
+
+        // Always counted in 512-byte sectors
+        quint64 size = sizeFile.readAll().simplified().toULongLong() * 512;
+        if (size == 0) continue;
+
+        QStringList details = { DiskDriveInfo::Instance().getModelName(QStringLiteral("/dev/%1").arg(entry)),
+                                formatSize(0, size).section('/', 1) };
+        details.removeAll(QString());
+        devices << QStringLiteral("/dev/%1 (%2)").arg(entry, details.join(QStringLiteral(", ")));
+    }
+
+    if (devices.isEmpty()) {
+        QMessageBox::critical(this, tr("Not available"), tr("No block devices were found."));
+        return;
+    }
+
+    bool ok;
+    QString device = QInputDialog::getItem(this, tr("Add a Raw Block Device"),
+                                           tr("The device is only read, write tests are skipped:"), devices, 0, false, &ok);
+    if (!ok) return;
+
+    device = device.section(' ', 0, 0);
+
+    int foundIndex = ui->comboBox_Storages->findText(device, Qt::MatchStartsWith);
+    if (foundIndex == -1) {
+        QFile sizeFile(QStringLiteral("/sys/block/%1/size").arg(device.mid(5)));
+        sizeFile.open(QIODevice::ReadOnly | QIODevice::Text);
+        qlonglong size = sizeFile.readAll().simplified().toLongLong() * 512;
+
+        Global::Storage storage {
+            .path = device,
+            .bytesTotal = size,
+            .bytesOccupied = 0,
+            .formatedSize = formatSize(0, size),
+            .permanentInList = true,
+            .rawDevice = true
+        };
+
+        addItemToStoragesList(storage);
+        resizeComboBoxItemsPopup(ui->comboBox_Storages);
+
+        foundIndex = ui->comboBox_Storages->count() - 1;
+    }
+
+    ui->comboBox_Storages->setCurrentIndex(foundIndex);
+}
+
+void MainWindow::on_actionAdditional_Targets_triggered()
+{
+    QVector<Global::Storage> storages;
+
+    for (int i = 0; i < ui->comboBox_Storages->count(); i++) {
+        QVariant variant = ui->comboBox_Storages->itemData(i);
+        if (i != ui->comboBox_Storages->currentIndex() && variant.canConvert<Global::Storage>()) {
+            // The benchmark file of a target is created in a directory, a raw device has none
+            const Global::Storage storage = variant.value<Global::Storage>();
+            if (!storage.rawDevice) storages << storage;
+        }
+    }
+
+    TargetsDialog dialog(storages, m_benchmark->getExtraDirs(), this);
+    if (dialog.exec() == QDialog::Accepted) {
+        m_benchmark->setExtraDirs(dialog.selectedDirs());
+        updateExtraTargetsAction();
+    }
+}
+
+void MainWindow::updateExtraTargetsAction()
+{
+    int count = m_benchmark->getExtraDirs().size();
+    ui->actionAdditional_Targets->setText(count > 0 ? tr("Additional Targets (%1)...").arg(count) : tr("Additional Targets..."));
+}
+
 void MainWindow::on_actionQueues_Threads_triggered()
 {
     Settings settings;
@@ -955,9 +1340,20 @@ void MainWindow::defineBenchmark(std::function<void()> bodyFunc)
         m_benchmark->setRunning(false);
     }
     else {
+        // The native engine neither limits the rate of its jobs nor detects a steady state
+        const bool nativeEngine = settings.getBenchmarkEngine() == Global::BenchmarkEngine::NativeIOUring;
+
         if (m_benchmark->getBenchmarkFile().isNull()) {
             QMessageBox::critical(this, tr("Not available"), tr("Directory is not specified."));
         }
+        else if (nativeEngine && settings.getComparisonUnit() == Global::ComparisonUnit::SLOIOPS) {
+            QMessageBox::critical(this, tr("Not available"), tr("The SLO IOPS search needs rate limited tests, which the native io_uring engine cannot run. "
+                                                                 "Choose another engine or comparison unit."));
+        }
+        else if (nativeEngine && settings.getPerformanceProfile() == Global::PerformanceProfile::SteadyState) {
+            QMessageBox::critical(this, tr("Not available"), tr("The native io_uring engine cannot detect a steady state. "
+                                                                 "Choose another engine or profile."));
+        }
         else {
             bodyFunc();
         }
@@ -982,21 +1378,115 @@ void MainWindow::handleResults(QProgressBar *progressBar, const Benchmark::Perfo
     progressBar->setProperty(metaEnum.valueToKey(Global::ComparisonUnit::GBPerSec), result.Bandwidth / 1000);
     progressBar->setProperty(metaEnum.valueToKey(Global::ComparisonUnit::IOPS), result.IOPS);
     progressBar->setProperty(metaEnum.valueToKey(Global::ComparisonUnit::Latency), result.Latency);
+    progressBar->setProperty(metaEnum.valueToKey(Global::ComparisonUnit::SLOIOPS), result.SLOIOPS);
+    progressBar->setProperty("Histogram", QVariant::fromValue(result.Histogram));
+    progressBar->setProperty("Samples", QVariant::fromValue(result.Samples));
+    progressBar->setProperty("SteadyStateTime", result.SteadyStateTime);
+    progressBar->setProperty("Targets", QVariant::fromValue(result.Targets));
 
-    if (!progressBar->property("Demo").toBool()) {
-        QLocale locale = QLocale();
+    updateToolTip(progressBar);
+    updateProgressBar(progressBar);
+}
+
+void MainWindow::showLatencyHistogram(QProgressBar *progressBar, const QString &title)
+{
+    HistogramWidget *view = new HistogramWidget(progressBar->property("Histogram").value<LatencyHistogram>(), this);
+    view->setWindowFlags(Qt::Window);
+    view->setAttribute(Qt::WA_DeleteOnClose);
+    view->setWindowTitle(QStringLiteral("%1 - %2").arg(tr("Latency Histogram"), title));
+
+    // Keep following the bar while the test is still running
+    connect(m_benchmark, &Benchmark::resultReady, view, [view, progressBar] (QProgressBar *bar, const Benchmark::PerformanceResult &result) {
+        if (bar == progressBar) view->setHistogram(result.Histogram);
+    });
+
+    view->show();
+}
+
+void MainWindow::updateToolTip(QProgressBar *progressBar)
+{
+    if (progressBar->property("Demo").toBool()) return;
+
+    QMetaEnum metaEnum = QMetaEnum::fromType<Global::ComparisonUnit>();
+
+    QLocale locale = QLocale();
+
+    QString toolTip = Global::getToolTipTemplate().arg(
+                locale.toString(progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::MBPerSec)).toFloat(), 'f', 3),
+                locale.toString(progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::GBPerSec)).toFloat(), 'f', 3),
+                locale.toString(progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::IOPS)).toFloat(), 'f', 3),
+                locale.toString(progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::Latency)).toFloat(), 'f', 3));
+
+    LatencyHistogram histogram = progressBar->property("Histogram").value<LatencyHistogram>();
 
-        progressBar->setToolTip(
-                    Global::getToolTipTemplate().arg(
-                        locale.toString(result.Bandwidth, 'f', 3),
-                        locale.toString(result.Bandwidth / 1000, 'f', 3),
-                        locale.toString(result.IOPS, 'f', 3),
-                        locale.toString(result.Latency, 'f', 3)
-                        )
-                    );
+    if (!histogram.isEmpty()) {
+        QStringList percentiles;
+        for (double percent : Global::getLatencyPercentiles()) {
+            percentiles << Global::getPercentileToolTipTemplate().arg(locale.toString(percent),
+                                                                      locale.toString(histogram.percentile(percent) / 1000., 'f', 3));
+        }
+        toolTip += QStringLiteral("<p>%1</p>").arg(percentiles.join("<br/>"));
     }
 
-    updateProgressBar(progressBar);
+    QVector<Benchmark::Sample> samples = progressBar->property("Samples").value<QVector<Benchmark::Sample>>();
+
+    if (samples.size() > 1) {
+        QStringList spread = { tr("Spread across %1 loops (mean ± 95% CI):").arg(samples.size()) };
+
+        const QVector<QPair<QString, float Benchmark::Sample::*>> fields = {
+            { tr("MB/s"), &Benchmark::Sample::Bandwidth },
+            { tr("IOPS"), &Benchmark::Sample::IOPS },
+            { tr("μs"), &Benchmark::Sample::Latency }
+        };
+
+        for (const auto &field : fields) {
+            Statistics::Summary summary = Benchmark::summarize(samples, field.second);
+            spread << Global::getSpreadToolTipTemplate().arg(field.first,
+                                                             locale.toString(summary.mean, 'f', 3),
+                                                             locale.toString(summary.ci95, 'f', 3),
+                                                             locale.toString(summary.median, 'f', 3),
+                                                             locale.toString(summary.min, 'f', 3),
+                                                             locale.toString(summary.max, 'f', 3),
+                                                             locale.toString(summary.stddev, 'f', 3));
+        }
+
+        toolTip += QStringLiteral("<p>%1</p>").arg(spread.join("<br/>"));
+    }
+
+    const AppSettings settings;
+
+    if (settings.getComparisonUnit() == Global::ComparisonUnit::SLOIOPS) {
+        toolTip += QStringLiteral("<p>%1</p>").arg(tr("%1 IOPS sustained with p%2 within %3 μs")
+                                                   .arg(locale.toString(progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::SLOIOPS)).toFloat(), 'f', 3),
+                                                        locale.toString(settings.getSLOPercentile()),
+                                                        locale.toString(settings.getSLOLatency())));
+    }
+
+    float steadyStateTime = progressBar->property("SteadyStateTime").toFloat();
+
+    if (steadyStateTime != 0) {
+        toolTip += QStringLiteral("<p>%1</p>").arg(steadyStateTime > 0
+                                                   ? tr("Steady state reached after %1 s").arg(locale.toString(steadyStateTime, 'f', 0))
+                                                   : tr("Steady state not reached within %1 s").arg(locale.toString(-steadyStateTime, 'f', 0)));
+    }
+
+    QVector<Benchmark::Sample> targets = progressBar->property("Targets").value<QVector<Benchmark::Sample>>();
+
+    if (targets.size() > 1) {
+        const QStringList dirs = QStringList(m_benchmark->getBenchmarkFile()) + m_benchmark->getExtraDirs();
+        QStringList lines = { tr("Per target:") };
+
+        for (int i = 0; i < targets.size(); i++) {
+            lines << tr("%1: %2 MB/s, %3 IOPS, %4 μs").arg(i < dirs.size() ? dirs.at(i) : QString::number(i + 1),
+                                                        locale.toString(targets.at(i).Bandwidth, 'f', 3),
+                                                        locale.toString(targets.at(i).IOPS, 'f', 3),
+                                                        locale.toString(targets.at(i).Latency, 'f', 3));
+        }
+
+        toolTip += QStringLiteral("<p>%1</p>").arg(lines.join("<br/>"));
+    }
+
+    progressBar->setToolTip(toolTip);
 }
 
 void MainWindow::updateProgressBar(QProgressBar *progressBar)
@@ -1014,6 +1504,7 @@ void MainWindow::updateProgressBar(QProgressBar *progressBar)
     switch (settings.getPerformanceProfile()) {
     case Global::PerformanceProfile::Peak:
     case Global::PerformanceProfile::RealWorld:
+    case Global::PerformanceProfile::SteadyState:
         if (progressBar == ui->readBar_3 || progressBar == ui->writeBar_3 || progressBar == ui->mixBar_3) {
             comparisonUnit = Global::ComparisonUnit::IOPS;
         }
@@ -1044,6 +1535,14 @@ void MainWindow::updateProgressBar(QProgressBar *progressBar)
         value = progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::Latency)).toFloat();
         progressBar->setFormat(value >= 1000000.0 ? locale.toString((int)value) : locale.toString(value, 'f', progressBar->property("Demo").toBool() ? 1 : 2));
         break;
+    case Global::ComparisonUnit::SLOIOPS:
+        value = progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::SLOIOPS)).toFloat();
+        progressBar->setFormat(value >= 1000000.0 ? locale.toString((int)value) : locale.toString(value, 'f', progressBar->property("Demo").toBool() ? 0 : 2));
+        // The bar keeps the throughput scale, shortened to the share of the IOPS that met the bound
+        if (progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::IOPS)).toFloat() > 0) {
+            score *= value / progressBar->property(metaEnum.valueToKey(Global::ComparisonUnit::IOPS)).toFloat();
+        }
+        break;
     }
 
     if (!progressBar->property("Demo").toBool()) {
@@ -1099,7 +1598,8 @@ bool MainWindow::runCombinedRandomTest()
 {
     const AppSettings settings;
 
-    if (settings.getPerformanceProfile() == Global::PerformanceProfile::Peak || settings.getPerformanceProfile() == Global::PerformanceProfile::RealWorld) {
+    if (settings.getPerformanceProfile() == Global::PerformanceProfile::Peak || settings.getPerformanceProfile() == Global::PerformanceProfile::RealWorld
+            || settings.getPerformanceProfile() == Global::PerformanceProfile::SteadyState) {
         QList<QPair<QPair<Global::BenchmarkTest, Global::BenchmarkIOReadWrite>, QVector<QProgressBar*>>> set {
             { { Global::Test_2, Global::Read  }, { ui->readBar_2,  ui->readBar_3,  ui->readBar_4  } },
             { { Global::Test_2, Global::Write }, { ui->writeBar_2, ui->writeBar_3, ui->writeBar_4 } }
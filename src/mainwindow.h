@@ -9,6 +9,17 @@
 class QComboBox;
 class QProgressBar;
 class QStorageInfo;
+class LiveChart;
+class SweepDialog;
+class ThreadScalingDialog;
+class LoadCurveDialog;
+class NumaDialog;
+class WorkloadsDialog;
+class WorkloadLibraryDialog;
+class TraceDialog;
+class CommitLatencyDialog;
+class MetadataDialog;
+class SmallFilesDialog;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -35,8 +46,32 @@ private slots:
 
     void on_actionAbout_triggered();
 
+    void on_actionLive_Chart_triggered();
+
+    void on_actionQueue_Depth_Block_Size_Sweep_triggered();
+
+    void on_actionThread_Scaling_triggered();
+
+    void on_actionLatency_vs_Load_triggered();
+
+    void on_actionNUMA_Placement_triggered();
+
+    void on_actionCustom_Workloads_triggered();
+
+    void on_actionWorkload_Library_triggered();
+
+    void on_actionTrace_Replay_triggered();
+
+    void on_actionCommit_Latency_triggered();
+    void on_actionMetadata_Operations_triggered();
+    void on_actionSmall_Files_triggered();
+
     void on_actionQueues_Threads_triggered();
 
+    void on_actionAdditional_Targets_triggered();
+
+    void on_actionAdd_Raw_Block_Device_triggered();
+
     void on_comboBox_Storages_currentIndexChanged(int index);
 
     void on_loopsCount_valueChanged(int arg1);
@@ -61,9 +96,22 @@ private slots:
 
     void on_actionCoW_detection_triggered(bool checked);
 
+    void on_actionKeep_Benchmark_File_triggered(bool checked);
+
 private:
     Ui::MainWindow *ui;
     Benchmark *m_benchmark;
+    LiveChart *m_liveChart = nullptr;
+    SweepDialog *m_sweepDialog = nullptr;
+    ThreadScalingDialog *m_threadScalingDialog = nullptr;
+    LoadCurveDialog *m_loadCurveDialog = nullptr;
+    NumaDialog *m_numaDialog = nullptr;
+    WorkloadsDialog *m_workloadsDialog = nullptr;
+    WorkloadLibraryDialog *m_workloadLibraryDialog = nullptr;
+    TraceDialog *m_traceDialog = nullptr;
+    CommitLatencyDialog *m_commitLatencyDialog = nullptr;
+    MetadataDialog *m_metadataDialog = nullptr;
+    SmallFilesDialog *m_smallFilesDialog = nullptr;
     QVector<QProgressBar*> m_progressBars;
     QString m_windowTitle;
 
@@ -78,6 +126,10 @@ private:
     void updatePresetsSelection();
     void refreshProgressBars();
     void updateProgressBar(QProgressBar *progressBar);
+    void updateToolTip(QProgressBar *progressBar);
+    void updateExtraTargetsAction();
+    QString storageItemText(const Global::Storage &storage);
+    void showLatencyHistogram(QProgressBar *progressBar, const QString &title);
     void updateLabels();
     bool runCombinedRandomTest();
     QString combineOutputTestResult(const QProgressBar *progressBar, const Global::BenchmarkParams &params);
@@ -93,6 +145,8 @@ public slots:
     void profileSelected(QAction* act);
     void modeSelected(QAction* act);
     void testDataSelected(QAction* act);
+    void engineSelected(QAction* act);
+    void preconditionSelected(QAction* act);
     void presetSelected(QAction* act);
     void themeSelected(QAction* act);
     void benchmarkStateChanged(bool state);
@@ -0,0 +1,134 @@
+#include "metadatadialog.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QComboBox>
+#include <QFormLayout>
+#include <QLabel>
+#include <QLocale>
+#include <QMessageBox>
+#include <QSpinBox>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "global.h"
+
+MetadataDialog::MetadataDialog(Benchmark *benchmark, QWidget *parent)
+    : ToolDialog(benchmark, parent)
+    , m_files(new QComboBox(this))
+    , m_filesPerDirectory(new QComboBox(this))
+    , m_threads(new QSpinBox(this))
+    , m_table(new QTreeWidget(this))
+{
+    setWindowTitle(tr("Metadata Operations"));
+
+    for (int files : { 1000, 10000, 100000, 1000000 }) {
+        m_files->addItem(QLocale().toString(files), files);
+    }
+    m_files->setCurrentIndex(m_files->findData(100000));
+
+    for (int files : { 10, 100, 1000, 10000, 100000 }) {
+        m_filesPerDirectory->addItem(QLocale().toString(files), files);
+    }
+    m_filesPerDirectory->setCurrentIndex(m_filesPerDirectory->findData(1000));
+    m_filesPerDirectory->setToolTip(tr("Large directories make every lookup and listing walk a bigger index"));
+
+    m_threads->setRange(1, 64);
+    m_threads->setValue(4);
+    m_threads->setToolTip(tr("Every thread works on its own directories of the tree"));
+
+    QStringList headers { tr("Operation"), tr("Cache"), tr("Ops/s"), tr("Mean μs") };
+    for (double percent : Global::getLatencyPercentiles()) {
+        headers << tr("p%1 μs").arg(percent);
+    }
+
+    m_table->setRootIsDecorated(false);
+    m_table->setHeaderLabels(headers);
+    m_table->headerItem()->setToolTip(1, tr("Cold phases start right after the dentry, inode and page caches were dropped"));
+    m_table->headerItem()->setToolTip(2, tr("Files per second, whole directory listings per second for readdir"));
+
+    QFormLayout *formLayout = new QFormLayout;
+    formLayout->addRow(tr("Files:"), m_files);
+    formLayout->addRow(tr("Files per directory:"), m_filesPerDirectory);
+    formLayout->addRow(tr("Threads:"), m_threads);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(formLayout);
+    layout->addWidget(m_table, 1);
+    layout->addLayout(createButtonLayout());
+
+    m_inputs = { m_files, m_filesPerDirectory, m_threads };
+}
+
+void MetadataDialog::updateResults()
+{
+    m_table->clear();
+
+    for (const Benchmark::MetadataPhase &phase : m_phases) {
+        QStringList columns { phase.operation, phase.cold ? tr("Cold") : tr("Warm"),
+                              QString::number(phase.opsPerSecond, 'f', 0), QString::number(phase.latency, 'f', 1) };
+
+        for (double percent : Global::getLatencyPercentiles()) {
+            columns << QString::number(phase.histogram.percentile(percent) / 1000.0, 'f', 1);
+        }
+
+        m_table->addTopLevelItem(new QTreeWidgetItem(columns));
+    }
+
+    for (int i = 0; i < m_table->columnCount(); i++) {
+        m_table->resizeColumnToContents(i);
+    }
+}
+
+bool MetadataDialog::prepareRun()
+{
+    if (m_benchmark->isRawDevice()) {
+        QMessageBox::critical(this, tr("Not available"), tr("The file tree is generated in a directory, a raw device has none."));
+        return false;
+    }
+
+    m_phases.clear();
+    updateResults();
+
+    m_status->setText(tr("Running"));
+
+    return true;
+}
+
+bool MetadataDialog::run()
+{
+    bool finished = m_benchmark->measureMetadata(m_files->currentData().toInt(), m_filesPerDirectory->currentData().toInt(),
+                                                 m_threads->value(), m_phases);
+
+    updateResults();
+
+    return finished;
+}
+
+bool MetadataDialog::hasResults() const
+{
+    return !m_phases.isEmpty();
+}
+
+void MetadataDialog::copyResults()
+{
+    QString header = QStringLiteral("operation,cache,ops_s,mean_us");
+    for (double percent : Global::getLatencyPercentiles()) {
+        header += QStringLiteral(",p%1_us").arg(percent);
+    }
+
+    QStringList lines { header };
+
+    for (const Benchmark::MetadataPhase &phase : m_phases) {
+        QString line = QStringLiteral("%1,%2,%3,%4").arg(phase.operation, phase.cold ? QStringLiteral("cold") : QStringLiteral("warm"))
+                       .arg(phase.opsPerSecond, 0, 'f', 3).arg(phase.latency, 0, 'f', 3);
+
+        for (double percent : Global::getLatencyPercentiles()) {
+            line += QStringLiteral(",%1").arg(phase.histogram.percentile(percent) / 1000.0, 0, 'f', 3);
+        }
+
+        lines << line;
+    }
+
+    QApplication::clipboard()->setText(lines.join('\n'));
+}
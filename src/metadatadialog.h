@@ -0,0 +1,38 @@
+#ifndef METADATADIALOG_H
+#define METADATADIALOG_H
+
+#include <QVector>
+
+#include "tooldialog.h"
+
+class QComboBox;
+class QSpinBox;
+class QTreeWidget;
+
+// Metadata operations per second the way mail and build servers load a filesystem: a tree of
+// small files is created, looked up, listed, renamed and removed, the lookups once with cold
+// and once with warm dentry and inode caches
+class MetadataDialog : public ToolDialog
+{
+    Q_OBJECT
+
+public:
+    explicit MetadataDialog(Benchmark *benchmark, QWidget *parent = nullptr);
+
+private:
+    bool prepareRun() override;
+    bool run() override;
+    bool hasResults() const override;
+    void copyResults() override;
+
+    void updateResults();
+
+    QComboBox *m_files;
+    QComboBox *m_filesPerDirectory;
+    QSpinBox *m_threads;
+    QTreeWidget *m_table;
+
+    QVector<Benchmark::MetadataPhase> m_phases;
+};
+
+#endif // METADATADIALOG_H
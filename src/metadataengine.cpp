@@ -0,0 +1,427 @@
+#include "metadataengine.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+uint64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+// Names are short and unique within their directory, so lookups compare few bytes
+void fileName(char *name, size_t size, char prefix, uint32_t index)
+{
+    snprintf(name, size, "%c%u", prefix, index);
+}
+
+// Reads the whole directory and returns the number of entries, -errno on failure
+long listDirectory(int directoryFd)
+{
+    // A fresh descriptor, so every listing starts at the beginning and goes through the lookup of "."
+    const int fd = openat(directoryFd, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return -errno;
+
+    alignas(8) char buffer[32768];
+    long entries = 0;
+
+    for (;;) {
+        const long size = syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+        if (size < 0) {
+            const int error = errno;
+            close(fd);
+            return -error;
+        }
+        if (size == 0) break;
+
+        for (long offset = 0; offset < size;) {
+            const auto *entry = reinterpret_cast<const dirent64*>(buffer + offset);
+            entries++;
+            offset += entry->d_reclen;
+        }
+    }
+
+    close(fd);
+    return entries;
+}
+
+}
+
+void MetadataEngine::PhaseStats::add(uint64_t latNs)
+{
+    if (ops == 0 || latNs < latMinNs) latMinNs = latNs;
+    if (latNs > latMaxNs) latMaxNs = latNs;
+    latSumNs += latNs;
+    lat.add(latNs);
+    ops++;
+}
+
+void MetadataEngine::PhaseStats::merge(const PhaseStats &other)
+{
+    if (other.ops == 0) return;
+
+    if (ops == 0 || other.latMinNs < latMinNs) latMinNs = other.latMinNs;
+    latMaxNs = std::max(latMaxNs, other.latMaxNs);
+    latSumNs += other.latSumNs;
+    lat.merge(other.lat);
+    ops += other.ops;
+}
+
+MetadataEngine::MetadataEngine(const Params &params) : m_params(params)
+{
+}
+
+MetadataEngine::~MetadataEngine()
+{
+    stop();
+}
+
+const char *MetadataEngine::operationName(Operation operation)
+{
+    switch (operation) {
+    case Create: return "create";
+    case Stat: return "stat";
+    case Open: return "open";
+    case Readdir: return "readdir";
+    case Rename: return "rename";
+    case Unlink: return "unlink";
+    }
+
+    return "";
+}
+
+const std::vector<MetadataEngine::Phase> &MetadataEngine::phases()
+{
+    // Create and unlink build and tear down the tree, so they only run once. The cold rename
+    // moves every file to a new name and the warm one moves it back.
+    static const std::vector<Phase> phases = {
+        { Create, false },
+        { Stat, true }, { Stat, false },
+        { Open, true }, { Open, false },
+        { Readdir, true }, { Readdir, false },
+        { Rename, true }, { Rename, false },
+        { Unlink, false }
+    };
+
+    return phases;
+}
+
+unsigned MetadataEngine::phaseCount()
+{
+    return unsigned(phases().size());
+}
+
+void MetadataEngine::start(std::function<void()> finished)
+{
+    m_stop = false;
+    m_running = true;
+    m_error = 0;
+    m_phase = 0;
+    m_ops = 0;
+    m_results.clear();
+
+    m_thread = std::thread([this, finished] {
+        run();
+
+        m_running = false;
+        finished();
+    });
+}
+
+void MetadataEngine::stop()
+{
+    m_stop = true;
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool MetadataEngine::isRunning() const
+{
+    return m_running;
+}
+
+const MetadataEngine::Params &MetadataEngine::params() const
+{
+    return m_params;
+}
+
+const std::vector<MetadataEngine::PhaseStats> &MetadataEngine::results() const
+{
+    return m_results;
+}
+
+int MetadataEngine::error() const
+{
+    return m_error;
+}
+
+unsigned MetadataEngine::currentPhase() const
+{
+    return m_phase;
+}
+
+uint64_t MetadataEngine::currentOps() const
+{
+    return m_ops.load(std::memory_order_relaxed);
+}
+
+uint64_t MetadataEngine::phaseOps(unsigned phase) const
+{
+    if (phase >= phaseCount()) return 0;
+
+    const uint32_t perDirectory = std::max(m_params.filesPerDirectory, 1u);
+    return phases()[phase].operation == Readdir ? (m_params.files + perDirectory - 1) / perDirectory : m_params.files;
+}
+
+void MetadataEngine::fail(int error)
+{
+    int expected = 0;
+    m_error.compare_exchange_strong(expected, error);
+    m_stop = true;
+}
+
+void MetadataEngine::run()
+{
+    if (!createTree()) {
+        removeTree();
+        return;
+    }
+
+    for (unsigned i = 0; i < phaseCount() && !m_stop; i++) {
+        const Phase &phase = phases()[i];
+
+        m_phase = i;
+        m_ops = 0;
+
+        if (phase.cold && !dropCaches()) break;
+
+        PhaseStats stats;
+        runPhase(phase, stats);
+
+        // A phase cut short would report the rate of whatever part of the tree it got to
+        if (!m_stop) m_results.push_back(std::move(stats));
+    }
+
+    removeTree();
+}
+
+bool MetadataEngine::createTree()
+{
+    std::string pattern = m_params.directory + "/kdiskmark-meta-XXXXXX";
+    if (!mkdtemp(&pattern[0])) {
+        fail(errno);
+        return false;
+    }
+
+    m_rootName = pattern;
+
+    // The directory was just created by us, so it must not turn into a link until it is opened
+    m_rootFd = open(m_rootName.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (m_rootFd < 0) {
+        fail(errno);
+        return false;
+    }
+
+    const uint32_t perDirectory = std::max(m_params.filesPerDirectory, 1u);
+    const uint32_t directories = std::max((m_params.files + perDirectory - 1) / perDirectory, 1u);
+
+    for (uint32_t i = 0; i < directories && !m_stop; i++) {
+        char name[32];
+        fileName(name, sizeof(name), 'd', i);
+
+        if (mkdirat(m_rootFd, name, 0700) != 0) {
+            fail(errno);
+            return false;
+        }
+
+        const int fd = openat(m_rootFd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (fd < 0) {
+            fail(errno);
+            return false;
+        }
+
+        m_directoryFds.push_back(fd);
+    }
+
+    return !m_stop;
+}
+
+void MetadataEngine::removeTree()
+{
+    // Whatever a stopped or failed phase left behind is listed and removed, the names don't matter
+    for (size_t i = 0; i < m_directoryFds.size(); i++) {
+        const int fd = dup(m_directoryFds[i]);
+        DIR *directory = fd >= 0 ? fdopendir(fd) : nullptr;
+
+        if (directory) {
+            std::vector<std::string> names;
+            while (dirent *entry = readdir(directory)) {
+                if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+                    names.emplace_back(entry->d_name);
+                }
+            }
+            closedir(directory);
+
+            for (const std::string &name : names) {
+                unlinkat(m_directoryFds[i], name.c_str(), 0);
+            }
+        }
+        else if (fd >= 0) {
+            close(fd);
+        }
+
+        close(m_directoryFds[i]);
+
+        char name[32];
+        fileName(name, sizeof(name), 'd', uint32_t(i));
+        unlinkat(m_rootFd, name, AT_REMOVEDIR);
+    }
+
+    m_directoryFds.clear();
+
+    if (m_rootFd >= 0) {
+        close(m_rootFd);
+        m_rootFd = -1;
+    }
+
+    if (!m_rootName.empty()) {
+        rmdir(m_rootName.c_str());
+        m_rootName.clear();
+    }
+}
+
+bool MetadataEngine::dropCaches()
+{
+    // Dirty inodes cannot be evicted, so the tree is written back first
+    if (syncfs(m_rootFd) != 0) {
+        fail(errno);
+        return false;
+    }
+
+    // 2 frees the dentries and inodes, 1 the page cache holding the directory blocks
+    const int fd = open("/proc/sys/vm/drop_caches", O_WRONLY | O_CLOEXEC);
+    if (fd < 0 || write(fd, "3", 1) != 1) {
+        fail(errno);
+        if (fd >= 0) close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+void MetadataEngine::runPhase(const Phase &phase, PhaseStats &stats)
+{
+    const unsigned threads = std::max(1u, std::min<unsigned>(m_params.threads, unsigned(m_directoryFds.size())));
+    std::vector<PhaseStats> workerStats(threads);
+
+    const uint64_t startNs = monotonicNs();
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; i++) {
+        workers.emplace_back(&MetadataEngine::runWorker, this, std::cref(phase), i, std::ref(workerStats[i]));
+    }
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    stats.operation = phase.operation;
+    stats.cold = phase.cold;
+    stats.runtimeNs = monotonicNs() - startNs;
+
+    for (const PhaseStats &worker : workerStats) {
+        stats.merge(worker);
+    }
+}
+
+void MetadataEngine::runWorker(const Phase &phase, unsigned index, PhaseStats &stats)
+{
+    const uint32_t perDirectory = std::max(m_params.filesPerDirectory, 1u);
+    const unsigned threads = std::max(1u, std::min<unsigned>(m_params.threads, unsigned(m_directoryFds.size())));
+
+    // Renames alternate between the two name sets, so both rename phases find their files
+    const char from = phase.operation == Rename && !phase.cold ? 'r' : 'f';
+    const char to = from == 'f' ? 'r' : 'f';
+
+    char name[32], newName[32];
+
+    for (size_t d = index; d < m_directoryFds.size() && !m_stop; d += threads) {
+        const int directoryFd = m_directoryFds[d];
+
+        if (phase.operation == Readdir) {
+            const uint64_t beginNs = monotonicNs();
+            const long entries = listDirectory(directoryFd);
+            const uint64_t endNs = monotonicNs();
+
+            if (entries < 0) {
+                fail(int(-entries));
+                return;
+            }
+
+            stats.add(endNs - beginNs);
+            m_ops.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        const uint32_t first = uint32_t(d) * perDirectory;
+        const uint32_t count = std::min(perDirectory, m_params.files - first);
+
+        for (uint32_t i = 0; i < count && !m_stop; i++) {
+            fileName(name, sizeof(name), from, i);
+
+            int result = 0;
+            struct stat st;
+
+            const uint64_t beginNs = monotonicNs();
+
+            switch (phase.operation) {
+            case Create:
+                result = openat(directoryFd, name, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+                if (result >= 0) result = close(result);
+                break;
+            case Stat:
+                result = fstatat(directoryFd, name, &st, AT_SYMLINK_NOFOLLOW);
+                break;
+            case Open:
+                result = openat(directoryFd, name, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+                if (result >= 0) result = close(result);
+                break;
+            case Rename:
+                fileName(newName, sizeof(newName), to, i);
+                result = renameat(directoryFd, name, directoryFd, newName);
+                break;
+            case Unlink:
+                result = unlinkat(directoryFd, name, 0);
+                break;
+            case Readdir:
+                break;
+            }
+
+            const uint64_t endNs = monotonicNs();
+
+            if (result < 0) {
+                fail(errno);
+                return;
+            }
+
+            stats.add(endNs - beginNs);
+            m_ops.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
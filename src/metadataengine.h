@@ -0,0 +1,104 @@
+#ifndef METADATAENGINE_H
+#define METADATAENGINE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "latencyhistogram.h"
+
+// Metadata benchmark engine. Generates a tree of empty files in a fresh directory inside the
+// target and times create, stat, open, readdir, rename and unlink calls on it, one phase per
+// operation. The lookups run twice, first after the dentry and inode caches were dropped and
+// then again with everything cached. Every thread owns its own directories of the tree.
+class MetadataEngine
+{
+public:
+    enum Operation { Create, Stat, Open, Readdir, Rename, Unlink };
+
+    struct Params
+    {
+        std::string directory; // the tree is generated in a new subdirectory of it
+        uint32_t files = 0;
+        uint32_t filesPerDirectory = 1000;
+        uint32_t threads = 1;
+    };
+
+    struct PhaseStats
+    {
+        Operation operation = Create;
+        bool cold = false; // caches were dropped before the phase
+        uint64_t ops = 0;
+        uint64_t runtimeNs = 0;
+        uint64_t latSumNs = 0;
+        uint64_t latMinNs = 0;
+        uint64_t latMaxNs = 0;
+        LatencyHistogram lat;
+
+        void add(uint64_t latNs);
+        void merge(const PhaseStats &other);
+    };
+
+    explicit MetadataEngine(const Params &params);
+    ~MetadataEngine();
+
+    MetadataEngine(const MetadataEngine&) = delete;
+    MetadataEngine& operator=(const MetadataEngine&) = delete;
+
+    static const char *operationName(Operation operation);
+
+    // Runs all phases on a background thread, finished is called from that thread.
+    // The tree is removed again before that, also when the run was stopped or failed.
+    void start(std::function<void()> finished);
+    // Joins the background thread, so it must not be called from finished, only by the owner
+    void stop();
+    bool isRunning() const;
+
+    const Params &params() const;
+    // Only valid once the finished callback has been called, the phases that were completed
+    const std::vector<PhaseStats> &results() const;
+    // errno of the first failure, 0 if none. Only valid once the finished callback has been called
+    int error() const;
+
+    // Index of the running phase in phaseCount() and the operations it has done so far
+    unsigned currentPhase() const;
+    uint64_t currentOps() const;
+    // Operations a phase does in total, directories for readdir and files for the others
+    uint64_t phaseOps(unsigned phase) const;
+    static unsigned phaseCount();
+
+private:
+    struct Phase
+    {
+        Operation operation;
+        bool cold;
+    };
+
+    static const std::vector<Phase> &phases();
+
+    void run();
+    bool createTree();
+    void removeTree();
+    bool dropCaches();
+    void runPhase(const Phase &phase, PhaseStats &stats);
+    void runWorker(const Phase &phase, unsigned index, PhaseStats &stats);
+    void fail(int error);
+
+    Params m_params;
+    std::atomic<bool> m_stop { false };
+    std::atomic<bool> m_running { false };
+    std::atomic<int> m_error { 0 };
+    std::atomic<unsigned> m_phase { 0 };
+    std::atomic<uint64_t> m_ops { 0 };
+    std::thread m_thread;
+    std::vector<PhaseStats> m_results;
+
+    int m_rootFd = -1;
+    std::string m_rootName;
+    std::vector<int> m_directoryFds;
+};
+
+#endif // METADATAENGINE_H
@@ -0,0 +1,211 @@
+#include "numadialog.h"
+
+#include <QComboBox>
+#include <QDir>
+#include <QFormLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QStorageInfo>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+#include "diskdriveinfo.h"
+
+NumaDialog::NumaDialog(Benchmark *benchmark, QWidget *parent)
+    : ToolDialog(benchmark, parent)
+    , m_device(new QLabel(this))
+    , m_pattern(createPatternCombo())
+    , m_blockSize(createBlockSizeCombo())
+    , m_queueDepth(createQueueDepthCombo())
+    , m_threads(new QSpinBox(this))
+    , m_localNode(new QComboBox(this))
+    , m_remoteNode(new QComboBox(this))
+    , m_table(new QTreeWidget(this))
+    , m_summary(new QLabel(this))
+{
+    setWindowTitle(tr("NUMA Placement"));
+
+    m_threads->setRange(1, 64);
+    m_threads->setValue(4);
+
+    for (int node : numaNodes()) {
+        m_localNode->addItem(QString::number(node), node);
+        m_remoteNode->addItem(QString::number(node), node);
+    }
+
+    m_table->setRootIsDecorated(false);
+    m_table->setHeaderLabels({ tr("Placement"), tr("MB/s"), tr("IOPS"), tr("μs"), tr("p99 μs") });
+
+    m_summary->setWordWrap(true);
+
+    QFormLayout *formLayout = new QFormLayout;
+    formLayout->addRow(tr("Device:"), m_device);
+    formLayout->addRow(tr("Pattern:"), m_pattern);
+    formLayout->addRow(tr("Block size:"), m_blockSize);
+    formLayout->addRow(tr("Queue depth:"), m_queueDepth);
+    formLayout->addRow(tr("Threads:"), m_threads);
+    formLayout->addRow(tr("Local node:"), m_localNode);
+    formLayout->addRow(tr("Remote node:"), m_remoteNode);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(formLayout);
+    layout->addWidget(m_table, 1);
+    layout->addWidget(m_summary);
+    layout->addLayout(createButtonLayout(false));
+
+    m_inputs = { m_pattern, m_blockSize, m_queueDepth, m_threads, m_localNode, m_remoteNode };
+}
+
+QVector<int> NumaDialog::numaNodes()
+{
+    QVector<int> nodes;
+
+    const QStringList entries = QDir(QStringLiteral("/sys/devices/system/node")).entryList({ QStringLiteral("node*") }, QDir::Dirs);
+    for (const QString &entry : entries) {
+        bool ok;
+        int node = entry.mid(4).toInt(&ok);
+        if (ok) nodes << node;
+    }
+
+    std::sort(nodes.begin(), nodes.end());
+
+    return nodes;
+}
+
+void NumaDialog::showEvent(QShowEvent *event)
+{
+    if (!m_running) updateDevice();
+
+    QDialog::showEvent(event);
+}
+
+void NumaDialog::updateDevice()
+{
+    const QString dir = m_benchmark->getBenchmarkFile();
+    const QString device = dir.isNull() || m_benchmark->isRawDevice() ? dir : QString(QStorageInfo(dir).device());
+    const int node = device.isEmpty() ? -1 : DiskDriveInfo::Instance().getNumaNode(device);
+
+    if (device.isEmpty()) {
+        m_device->setText(tr("Directory is not specified."));
+    }
+    else if (node < 0) {
+        m_device->setText(tr("%1, no NUMA node reported").arg(device));
+    }
+    else {
+        m_device->setText(tr("%1, NUMA node %2").arg(device).arg(node));
+    }
+
+    // The remote side defaults to the first node the device is not attached to
+    int local = qMax(0, m_localNode->findData(node));
+    m_localNode->setCurrentIndex(local);
+    m_remoteNode->setCurrentIndex(local == 0 && m_remoteNode->count() > 1 ? 1 : 0);
+
+    if (m_localNode->count() < 2) {
+        m_status->setText(tr("Only one NUMA node, there is nothing to compare."));
+    }
+
+    m_startButton->setEnabled(canStart() && !m_benchmark->isRunning());
+}
+
+bool NumaDialog::canStart() const
+{
+    return m_localNode->count() > 1;
+}
+
+void NumaDialog::showResults(const Benchmark::PerformanceResult &local, const Benchmark::PerformanceResult &remote)
+{
+    m_table->clear();
+
+    auto addRow = [this] (const QString &placement, const Benchmark::PerformanceResult &result) {
+        m_table->addTopLevelItem(new QTreeWidgetItem({
+            placement,
+            QString::number(result.Bandwidth, 'f', 1),
+            QString::number(result.IOPS, 'f', 0),
+            QString::number(result.Latency, 'f', 1),
+            QString::number(result.percentile(99), 'f', 1)
+        }));
+    };
+
+    addRow(tr("Local node %1").arg(m_localNode->currentText()), local);
+    addRow(tr("Remote node %1").arg(m_remoteNode->currentText()), remote);
+
+    if (local.IOPS <= 0 || local.Latency <= 0) {
+        m_summary->clear();
+        return;
+    }
+
+    auto change = [] (float remote, float local) {
+        return local > 0 ? (remote / local - 1) * 100 : 0;
+    };
+
+    m_table->addTopLevelItem(new QTreeWidgetItem({
+        tr("Penalty"),
+        QStringLiteral("%1%").arg(change(remote.Bandwidth, local.Bandwidth), 0, 'f', 1),
+        QStringLiteral("%1%").arg(change(remote.IOPS, local.IOPS), 0, 'f', 1),
+        QStringLiteral("%1%").arg(change(remote.Latency, local.Latency), 0, 'f', 1),
+        QStringLiteral("%1%").arg(change(remote.percentile(99), local.percentile(99)), 0, 'f', 1)
+    }));
+
+    m_summary->setText(tr("Crossing from node %1 to node %2 costs %3% of the IOPS and adds %4 μs (%5%) of mean latency.")
+                       .arg(m_localNode->currentText(), m_remoteNode->currentText())
+                       .arg(-change(remote.IOPS, local.IOPS), 0, 'f', 1)
+                       .arg(remote.Latency - local.Latency, 0, 'f', 1)
+                       .arg(change(remote.Latency, local.Latency), 0, 'f', 1));
+}
+
+bool NumaDialog::prepareRun()
+{
+    if (m_localNode->currentIndex() == m_remoteNode->currentIndex()) {
+        QMessageBox::critical(this, tr("Not available"), tr("The local and the remote node must differ."));
+        return false;
+    }
+
+    m_table->clear();
+    m_summary->clear();
+
+    return true;
+}
+
+bool NumaDialog::run()
+{
+    // Threads are bound to the node and allocate their buffers there
+    const QVariantMap localOptions {
+        { "numa_cpu_nodes", m_localNode->currentText() },
+        { "numa_mem_policy", "local" }
+    };
+    const QVariantMap remoteOptions {
+        { "numa_cpu_nodes", m_remoteNode->currentText() },
+        { "numa_mem_policy", "local" }
+    };
+
+    const QString rw = m_pattern->currentData().toString();
+    const int blockSize = m_blockSize->currentData().toInt();
+    const int queueDepth = m_queueDepth->currentData().toInt();
+    const int threads = m_threads->value();
+    const int loops = AppSettings().getLoopsCount();
+
+    Benchmark::PerformanceResult local { 0, 0, 0 }, remote { 0, 0, 0 };
+
+    // Alternating the placements keeps drift of the device from favouring either side
+    for (int i = 0; i < loops * 2; i++) {
+        const bool isLocal = i % 2 == 0;
+
+        updateEta(i, loops * 2);
+
+        Benchmark::PerformanceResult result;
+        if (!m_benchmark->measure({ rw, blockSize, queueDepth, threads, isLocal ? localOptions : remoteOptions }, result,
+                                  tr("NUMA %1 node %2 (%3/%4)").arg(isLocal ? tr("local") : tr("remote"))
+                                  .arg(isLocal ? m_localNode->currentText() : m_remoteNode->currentText())
+                                  .arg(i + 1).arg(loops * 2))) return false;
+
+        (isLocal ? local : remote) += result;
+
+        if (!isLocal) showResults(local / (i / 2 + 1), remote / (i / 2 + 1));
+    }
+
+    return true;
+}
@@ -0,0 +1,44 @@
+#ifndef NUMADIALOG_H
+#define NUMADIALOG_H
+
+#include "tooldialog.h"
+
+class QComboBox;
+class QLabel;
+class QSpinBox;
+class QTreeWidget;
+
+// Runs the same job with threads and buffers on the device's own NUMA node
+// and on a remote one, and reports what crossing the interconnect costs
+class NumaDialog : public ToolDialog
+{
+    Q_OBJECT
+
+public:
+    explicit NumaDialog(Benchmark *benchmark, QWidget *parent = nullptr);
+
+    static QVector<int> numaNodes();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private:
+    bool canStart() const override;
+    bool prepareRun() override;
+    bool run() override;
+
+    void updateDevice();
+    void showResults(const Benchmark::PerformanceResult &local, const Benchmark::PerformanceResult &remote);
+
+    QLabel *m_device;
+    QComboBox *m_pattern;
+    QComboBox *m_blockSize;
+    QComboBox *m_queueDepth;
+    QSpinBox *m_threads;
+    QComboBox *m_localNode;
+    QComboBox *m_remoteNode;
+    QTreeWidget *m_table;
+    QLabel *m_summary;
+};
+
+#endif // NUMADIALOG_H
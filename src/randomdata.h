@@ -0,0 +1,71 @@
+#ifndef RANDOMDATA_H
+#define RANDOMDATA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// xorshift64*, good enough to defeat compression and deduplication
+inline uint64_t nextRandom(uint64_t &state)
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1Dull;
+}
+
+inline void fillRandom(void *buffer, size_t size, uint64_t &state)
+{
+    auto *data = static_cast<uint64_t*>(buffer);
+    for (size_t i = 0; i < size / sizeof(uint64_t); i++) {
+        data[i] = nextRandom(state);
+    }
+}
+
+// Test data for storage that compresses or deduplicates inline, the same knobs as fio's
+// buffer_compress_percentage and dedupe_percentage. Both 0 give plain random data.
+struct DataPattern
+{
+    uint32_t compressPercentage = 0; // zeroed share of every block
+    uint32_t dedupePercentage = 0; // share of blocks that repeat one of a few shared blocks
+
+    bool isRandom() const { return compressPercentage == 0 && dedupePercentage == 0; }
+    bool operator==(const DataPattern &other) const
+    {
+        return compressPercentage == other.compressPercentage && dedupePercentage == other.dedupePercentage;
+    }
+    bool operator!=(const DataPattern &other) const { return !(*this == other); }
+};
+
+// Deduplication works on whole blocks, 4 KiB is the usual granularity of VDO, ZFS and SSD controllers
+constexpr size_t DataPatternBlockSize = 4096;
+
+inline void fillPattern(void *buffer, size_t size, uint64_t &state, const DataPattern &pattern)
+{
+    if (pattern.isRandom()) {
+        fillRandom(buffer, size, state);
+        return;
+    }
+
+    // Few enough that every shared block repeats many times, even in small files
+    constexpr uint64_t DedupeBlocks = 16;
+
+    auto *data = static_cast<char*>(buffer);
+    for (size_t offset = 0; offset < size; offset += DataPatternBlockSize) {
+        const size_t blockSize = size - offset < DataPatternBlockSize ? size - offset : DataPatternBlockSize;
+        const size_t randomSize = blockSize * (100 - pattern.compressPercentage) / 100 / sizeof(uint64_t) * sizeof(uint64_t);
+
+        if (nextRandom(state) % 100 < pattern.dedupePercentage) {
+            // The seed alone decides the contents, so the block is identical wherever it lands
+            uint64_t sharedState = 0x9E3779B97F4A7C15ull * (1 + nextRandom(state) % DedupeBlocks);
+            fillRandom(data + offset, randomSize, sharedState);
+        }
+        else {
+            fillRandom(data + offset, randomSize, state);
+        }
+
+        memset(data + offset + randomSize, 0, blockSize - randomSize);
+    }
+}
+
+#endif // RANDOMDATA_H
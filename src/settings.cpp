@@ -41,6 +41,14 @@ Settings::Settings(QWidget *parent) :
 
     findDataAndSet(ui->MeasuringTime, settings.getMeasuringTime());
     findDataAndSet(ui->IntervalTime, settings.getIntervalTime());
+    findDataAndSet(ui->AdaptiveTargetCI, settings.getAdaptiveTargetCI());
+    findDataAndSet(ui->AdaptiveMaxLoops, settings.getAdaptiveMaxLoops());
+    findDataAndSet(ui->AdaptiveTimeBudget, settings.getAdaptiveTimeBudget());
+    ui->SLOPercentile->setCurrentIndex(ui->SLOPercentile->findData(settings.getSLOPercentile()));
+    findDataAndSet(ui->SLOLatency, settings.getSLOLatency());
+    findDataAndSet(ui->CompressPercentage, settings.getCompressPercentage());
+    findDataAndSet(ui->DedupePercentage, settings.getDedupePercentage());
+    findDataAndSet(ui->SteadyStateTimeBudget, settings.getSteadyStateTimeBudget());
 }
 
 Settings::~Settings()
@@ -82,6 +90,14 @@ void Settings::on_buttonBox_clicked(QAbstractButton *button)
 
         settings.setMeasuringTime(ui->MeasuringTime->currentData().toInt());
         settings.setIntervalTime(ui->IntervalTime->currentData().toInt());
+        settings.setAdaptiveTargetCI(ui->AdaptiveTargetCI->currentData().toInt());
+        settings.setAdaptiveMaxLoops(ui->AdaptiveMaxLoops->currentData().toInt());
+        settings.setAdaptiveTimeBudget(ui->AdaptiveTimeBudget->currentData().toInt());
+        settings.setSLOPercentile(ui->SLOPercentile->currentData().toDouble());
+        settings.setSLOLatency(ui->SLOLatency->currentData().toInt());
+        settings.setCompressPercentage(ui->CompressPercentage->currentData().toInt());
+        settings.setDedupePercentage(ui->DedupePercentage->currentData().toInt());
+        settings.setSteadyStateTimeBudget(ui->SteadyStateTimeBudget->currentData().toInt());
 
         close();
     }
@@ -107,6 +123,45 @@ void Settings::populateComboBoxes()
                                             : QStringLiteral("%1 %2").arg(val / 60).arg(tr("min")), val);
     }
 
+    // Adaptive loop count, stops once the confidence interval is narrower than the target
+    ui->AdaptiveTargetCI->addItem(tr("Off"), 0);
+    for (int val : { 1, 2, 5, 10 }) {
+        ui->AdaptiveTargetCI->addItem(QStringLiteral("± %1%").arg(val), val);
+    }
+
+    for (int val : { 5, 10, 20, 30, 50, 100 }) {
+        ui->AdaptiveMaxLoops->addItem(QString::number(val), val);
+    }
+
+    for (int val : { 60, 300, 600, 1800, 3600 }) {
+        ui->AdaptiveTimeBudget->addItem(QStringLiteral("%1 %2").arg(val / 60).arg(tr("min")), val);
+    }
+
+    // Longest a steady state test may run when the IOPS never settle
+    for (int val : { 300, 600, 1800, 3600 }) {
+        ui->SteadyStateTimeBudget->addItem(QStringLiteral("%1 %2").arg(val / 60).arg(tr("min")), val);
+    }
+
+    // Bound of the SLO IOPS comparison unit
+    for (double val : { 99., 99.9 }) {
+        ui->SLOPercentile->addItem(QStringLiteral("p%1").arg(val), val);
+    }
+
+    for (int val : { 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000 }) {
+        ui->SLOLatency->addItem(val < 1000 ? QStringLiteral("%1 %2").arg(val).arg(tr("μs"))
+                                           : QStringLiteral("%1 %2").arg(val / 1000).arg(tr("ms")), val);
+    }
+
+    // Shape of the compressible test data, the ratio is what an ideal compressor gets out of it
+    for (int val : { 0, 25, 50, 67, 75, 80, 90 }) {
+        ui->CompressPercentage->addItem(val > 0 ? QStringLiteral("%1% (%2:1)").arg(val).arg(100. / (100 - val), 0, 'f', 1)
+                                                : QStringLiteral("%1%").arg(val), val);
+    }
+
+    for (int val : { 0, 10, 25, 50, 75, 90 }) {
+        ui->DedupePercentage->addItem(QStringLiteral("%1%").arg(val), val);
+    }
+
     // Collect all pattern combo boxes
     QVector<QComboBox*> patternBoxes = {
         ui->DefaultProfile_Test_1_Pattern, ui->DefaultProfile_Test_2_Pattern,
@@ -278,4 +333,12 @@ void Settings::applyPreset(Global::BenchmarkPreset preset)
 
     findDataAndSet(ui->MeasuringTime, settings.defaultMeasuringTime());
     findDataAndSet(ui->IntervalTime, settings.defaultIntervalTime());
+    findDataAndSet(ui->AdaptiveTargetCI, settings.defaultAdaptiveTargetCI());
+    findDataAndSet(ui->AdaptiveMaxLoops, settings.defaultAdaptiveMaxLoops());
+    findDataAndSet(ui->AdaptiveTimeBudget, settings.defaultAdaptiveTimeBudget());
+    ui->SLOPercentile->setCurrentIndex(ui->SLOPercentile->findData(settings.defaultSLOPercentile()));
+    findDataAndSet(ui->SLOLatency, settings.defaultSLOLatency());
+    findDataAndSet(ui->CompressPercentage, settings.defaultCompressPercentage());
+    findDataAndSet(ui->DedupePercentage, settings.defaultDedupePercentage());
+    findDataAndSet(ui->SteadyStateTimeBudget, settings.defaultSteadyStateTimeBudget());
 }
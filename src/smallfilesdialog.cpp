@@ -0,0 +1,190 @@
+#include "smallfilesdialog.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QComboBox>
+#include <QFormLayout>
+#include <QLabel>
+#include <QLocale>
+#include <QMessageBox>
+#include <QSpinBox>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "global.h"
+
+SmallFilesDialog::SmallFilesDialog(Benchmark *benchmark, QWidget *parent)
+    : ToolDialog(benchmark, parent)
+    , m_files(new QComboBox(this))
+    , m_fileSize(createBlockSizeCombo(16, 256))
+    , m_threads(new QSpinBox(this))
+    , m_openFiles(new QSpinBox(this))
+    , m_table(new QTreeWidget(this))
+{
+    setWindowTitle(tr("Small Files"));
+
+    for (int files : { 10000, 100000, 1000000 }) {
+        m_files->addItem(QLocale().toString(files), files);
+    }
+    m_files->setCurrentIndex(m_files->findData(100000));
+
+    m_fileSize->setToolTip(tr("Every file is read or written whole by a single request"));
+
+    m_threads->setRange(1, 64);
+    m_threads->setValue(4);
+    m_threads->setToolTip(tr("Threads that share the file set, each with one request in flight"));
+
+    m_openFiles->setRange(1, 4096);
+    m_openFiles->setValue(64);
+    m_openFiles->setToolTip(tr("Files a thread keeps open at once, the others are closed and opened again when their turn comes"));
+
+    QStringList headers { tr("Mode"), tr("Files/s"), tr("MB/s"), tr("Mean μs"), tr("fsync μs") };
+    for (double percent : Global::getLatencyPercentiles()) {
+        headers << tr("p%1 μs").arg(percent);
+    }
+
+    m_table->setRootIsDecorated(false);
+    m_table->setHeaderLabels(headers);
+
+    QFormLayout *formLayout = new QFormLayout;
+    formLayout->addRow(tr("Files:"), m_files);
+    formLayout->addRow(tr("File size:"), m_fileSize);
+    formLayout->addRow(tr("Threads:"), m_threads);
+    formLayout->addRow(tr("Open files:"), m_openFiles);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(formLayout);
+    layout->addWidget(m_table, 1);
+    layout->addLayout(createButtonLayout());
+
+    m_inputs = { m_files, m_fileSize, m_threads, m_openFiles };
+
+    m_modes = modes();
+    updateResults();
+}
+
+QVector<SmallFilesDialog::Mode> SmallFilesDialog::modes() const
+{
+    // A whole file per request, so switching to a random file after every request visits them in random order
+    const QVariantMap options {
+        { "fileset", "1" },
+        { "file_service_type", "random" },
+        { "openfiles", QString::number(m_openFiles->value()) }
+    };
+
+    QVariantMap fsyncOptions = options;
+    fsyncOptions["fsync"] = "1";
+
+    return {
+        { tr("Read"), QStringLiteral("read"), options },
+        { tr("Write"), QStringLiteral("write"), options },
+        { tr("Write + fsync per file"), QStringLiteral("write"), fsyncOptions }
+    };
+}
+
+const Benchmark::PerformanceResult &SmallFilesDialog::transfer(const Mode &mode)
+{
+    return mode.rw == QLatin1String("read") ? mode.job.read : mode.job.write;
+}
+
+void SmallFilesDialog::updateResults()
+{
+    m_table->clear();
+
+    const QString none = QStringLiteral("–");
+
+    for (const Mode &mode : m_modes) {
+        QStringList columns { mode.name };
+
+        if (mode.measured) {
+            columns << QString::number(transfer(mode).IOPS, 'f', 0)
+                    << QString::number(transfer(mode).Bandwidth, 'f', 1)
+                    << QString::number(transfer(mode).Latency, 'f', 1)
+                    << (mode.options.contains("fsync") ? QString::number(mode.job.sync.Latency, 'f', 1) : none);
+
+            for (double percent : Global::getLatencyPercentiles()) {
+                columns << QString::number(transfer(mode).Histogram.percentile(percent) / 1000.0, 'f', 1);
+            }
+        }
+        else {
+            while (columns.size() < m_table->columnCount()) columns << none;
+        }
+
+        m_table->addTopLevelItem(new QTreeWidgetItem(columns));
+    }
+
+    for (int i = 0; i < m_table->columnCount(); i++) {
+        m_table->resizeColumnToContents(i);
+    }
+}
+
+bool SmallFilesDialog::prepareRun()
+{
+    if (m_benchmark->isRawDevice()) {
+        QMessageBox::critical(this, tr("Not available"), tr("The files are created in a directory, a raw device has none."));
+        return false;
+    }
+
+    m_modes = modes();
+    updateResults();
+
+    return true;
+}
+
+bool SmallFilesDialog::run()
+{
+    const int files = m_files->currentData().toInt();
+    const int fileSize = m_fileSize->currentData().toInt();
+    const int threads = m_threads->value();
+
+    m_status->setText(tr("Creating %1 files").arg(QLocale().toString(files)));
+
+    if (!m_benchmark->prepareFileSet(files, fileSize)) return false;
+
+    for (int i = 0; i < m_modes.size(); i++) {
+        Mode &mode = m_modes[i];
+
+        m_status->setText(tr("Running %1 of %2").arg(i + 1).arg(m_modes.size()));
+
+        Benchmark::TestSpec spec { mode.rw, fileSize, 1, threads, mode.options };
+
+        if (!m_benchmark->measure(spec, mode.job, tr("%1 (%2/%3)").arg(mode.name).arg(i + 1).arg(m_modes.size()))) return false;
+
+        mode.measured = true;
+
+        updateResults();
+    }
+
+    return true;
+}
+
+bool SmallFilesDialog::hasResults() const
+{
+    return !m_modes.isEmpty() && m_modes.first().measured;
+}
+
+void SmallFilesDialog::copyResults()
+{
+    QString header = QStringLiteral("mode,files_s,mb_s,mean_us,fsync_us");
+    for (double percent : Global::getLatencyPercentiles()) {
+        header += QStringLiteral(",p%1_us").arg(percent);
+    }
+
+    QStringList lines { header };
+
+    for (const Mode &mode : m_modes) {
+        if (!mode.measured) continue;
+
+        QString line = QStringLiteral("\"%1\",%2,%3,%4,%5").arg(mode.name).arg(transfer(mode).IOPS, 0, 'f', 3)
+                       .arg(transfer(mode).Bandwidth, 0, 'f', 3).arg(transfer(mode).Latency, 0, 'f', 3)
+                       .arg(mode.options.contains("fsync") ? QString::number(mode.job.sync.Latency, 'f', 3) : QString());
+
+        for (double percent : Global::getLatencyPercentiles()) {
+            line += QStringLiteral(",%1").arg(transfer(mode).Histogram.percentile(percent) / 1000.0, 0, 'f', 3);
+        }
+
+        lines << line;
+    }
+
+    QApplication::clipboard()->setText(lines.join('\n'));
+}
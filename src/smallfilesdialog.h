@@ -0,0 +1,52 @@
+#ifndef SMALLFILESDIALOG_H
+#define SMALLFILESDIALOG_H
+
+#include <QVector>
+
+#include "tooldialog.h"
+
+class QComboBox;
+class QSpinBox;
+class QTreeWidget;
+
+// Throughput over a large population of small files: the set is created next to the benchmark
+// file, then read and written a whole file per request in random file order, once more with
+// an fsync after every file
+class SmallFilesDialog : public ToolDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SmallFilesDialog(Benchmark *benchmark, QWidget *parent = nullptr);
+
+private:
+    bool prepareRun() override;
+    bool run() override;
+    bool hasResults() const override;
+    void copyResults() override;
+
+    struct Mode
+    {
+        QString name;
+        QString rw;
+        QVariantMap options;
+        bool measured = false;
+        Benchmark::ParsedJob job {{ 0, 0, 0 }, { 0, 0, 0 }};
+    };
+
+    QVector<Mode> modes() const;
+
+    static const Benchmark::PerformanceResult &transfer(const Mode &mode);
+
+    void updateResults();
+
+    QComboBox *m_files;
+    QComboBox *m_fileSize;
+    QSpinBox *m_threads;
+    QSpinBox *m_openFiles;
+    QTreeWidget *m_table;
+
+    QVector<Mode> m_modes;
+};
+
+#endif // SMALLFILESDIALOG_H
@@ -0,0 +1,76 @@
+#include "statistics.h"
+
+#include <algorithm>
+
+#include "math.h"
+
+double Statistics::Summary::relativeCI() const
+{
+    return count > 1 && mean != 0 ? ci95 / fabs(mean) : 0;
+}
+
+Statistics::Summary Statistics::summarize(QVector<double> samples)
+{
+    Summary summary;
+    summary.count = samples.size();
+
+    if (samples.isEmpty()) return summary;
+
+    std::sort(samples.begin(), samples.end());
+
+    const int n = samples.size();
+
+    summary.min = samples.first();
+    summary.max = samples.last();
+    summary.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+
+    for (double sample : samples) summary.mean += sample;
+    summary.mean /= n;
+
+    if (n > 1) {
+        double squares = 0;
+        for (double sample : samples) squares += (sample - summary.mean) * (sample - summary.mean);
+
+        summary.stddev = sqrt(squares / (n - 1));
+        summary.ci95 = studentT95(n - 1) * summary.stddev / sqrt(n);
+    }
+
+    return summary;
+}
+
+double Statistics::relativeExcursion(const QVector<double> &samples)
+{
+    const int n = samples.size();
+    if (n < 2) return 0;
+
+    double meanX = (n - 1) / 2.0, meanY = 0;
+    for (double sample : samples) meanY += sample;
+    meanY /= n;
+
+    if (meanY == 0) return 0;
+
+    double covariance = 0, variance = 0;
+    for (int i = 0; i < n; i++) {
+        covariance += (i - meanX) * (samples[i] - meanY);
+        variance += (i - meanX) * (i - meanX);
+    }
+
+    return fabs(covariance / variance * (n - 1) / meanY);
+}
+
+double Statistics::studentT95(int degreesOfFreedom)
+{
+    static const double table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+
+    if (degreesOfFreedom < 1) return 0;
+    if (degreesOfFreedom <= 30) return table[degreesOfFreedom - 1];
+    // Rounded towards the lower end of each range to stay conservative
+    if (degreesOfFreedom <= 40) return 2.042;
+    if (degreesOfFreedom <= 60) return 2.021;
+    if (degreesOfFreedom <= 120) return 2.000;
+    return 1.960;
+}
@@ -0,0 +1,29 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <QVector>
+
+namespace Statistics
+{
+    struct Summary
+    {
+        int count = 0;
+        double mean = 0;
+        double median = 0;
+        double min = 0;
+        double max = 0;
+        double stddev = 0; // sample standard deviation
+        double ci95 = 0; // half width of the 95% confidence interval of the mean
+
+        // ci95 relative to the mean, 0 when it cannot be computed yet
+        double relativeCI() const;
+    };
+
+    Summary summarize(QVector<double> samples);
+    // Change of the least squares line across the samples relative to their mean (SNIA slope excursion)
+    double relativeExcursion(const QVector<double> &samples);
+    // Two-sided Student's t critical value for a 95% confidence level
+    double studentT95(int degreesOfFreedom);
+}
+
+#endif // STATISTICS_H
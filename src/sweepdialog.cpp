@@ -0,0 +1,212 @@
+#include "sweepdialog.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QComboBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+#include "global.h"
+#include "heatmapwidget.h"
+
+SweepDialog::SweepDialog(Benchmark *benchmark, QWidget *parent)
+    : ToolDialog(benchmark, parent)
+    , m_pattern(createPatternCombo())
+    , m_queueDepthFrom(createQueueDepthCombo(1))
+    , m_queueDepthTo(createQueueDepthCombo(256))
+    , m_blockSizeFrom(createBlockSizeCombo(4))
+    , m_blockSizeTo(createBlockSizeCombo(8192))
+    , m_threads(new QSpinBox(this))
+    , m_metric(new QComboBox(this))
+    , m_heatmap(new HeatmapWidget(this))
+    , m_knees(new QLabel(this))
+{
+    setWindowTitle(tr("Queue Depth × Block Size Sweep"));
+
+    m_threads->setRange(1, 64);
+
+    m_metric->addItem(tr("MB/s"));
+    m_metric->addItem(tr("IOPS"));
+    m_metric->addItem(tr("μs"));
+    m_metric->setCurrentIndex(1);
+
+    m_knees->setWordWrap(true);
+    m_knees->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    QHBoxLayout *queueDepthLayout = new QHBoxLayout;
+    queueDepthLayout->addWidget(m_queueDepthFrom);
+    queueDepthLayout->addWidget(new QLabel(QStringLiteral("–"), this));
+    queueDepthLayout->addWidget(m_queueDepthTo);
+
+    QHBoxLayout *blockSizeLayout = new QHBoxLayout;
+    blockSizeLayout->addWidget(m_blockSizeFrom);
+    blockSizeLayout->addWidget(new QLabel(QStringLiteral("–"), this));
+    blockSizeLayout->addWidget(m_blockSizeTo);
+
+    QFormLayout *formLayout = new QFormLayout;
+    formLayout->addRow(tr("Pattern:"), m_pattern);
+    formLayout->addRow(tr("Queue depth:"), queueDepthLayout);
+    formLayout->addRow(tr("Block size:"), blockSizeLayout);
+    formLayout->addRow(tr("Threads:"), m_threads);
+    formLayout->addRow(tr("Show:"), m_metric);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(formLayout);
+    layout->addWidget(m_heatmap, 1);
+    layout->addWidget(m_knees);
+    layout->addLayout(createButtonLayout());
+
+    connect(m_metric, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SweepDialog::updateHeatmap);
+
+    m_inputs = { m_pattern, m_queueDepthFrom, m_queueDepthTo, m_blockSizeFrom, m_blockSizeTo, m_threads };
+}
+
+QVector<int> SweepDialog::range(QComboBox *from, QComboBox *to)
+{
+    QVector<int> values;
+
+    int first = qMin(from->currentIndex(), to->currentIndex());
+    int last = qMax(from->currentIndex(), to->currentIndex());
+
+    for (int i = first; i <= last; i++) {
+        values << from->itemData(i).toInt();
+    }
+
+    return values;
+}
+
+QString SweepDialog::formatValue(const Benchmark::Sample &sample) const
+{
+    switch (m_metric->currentIndex())
+    {
+        case 0:
+            return QString::number(sample.Bandwidth, 'f', sample.Bandwidth < 100 ? 1 : 0);
+        case 1:
+            return QString::number(sample.IOPS, 'f', 0);
+        default:
+            return QString::number(sample.Latency, 'f', sample.Latency < 100 ? 1 : 0);
+    }
+}
+
+int SweepDialog::kneeIndex(const QVector<Benchmark::Sample> &samples)
+{
+    // Past the knee extra queue depth mostly adds waiting time: by Little's law
+    // latency then grows faster than the throughput it buys
+    for (int i = 1; i < samples.size(); i++) {
+        const Benchmark::Sample &previous = samples.at(i - 1);
+        const Benchmark::Sample &current = samples.at(i);
+
+        if (previous.IOPS <= 0 || previous.Latency <= 0) continue;
+
+        double latencyGrowth = current.Latency / previous.Latency - 1;
+        double throughputGrowth = current.IOPS / previous.IOPS - 1;
+
+        if (latencyGrowth > throughputGrowth) return i - 1;
+    }
+
+    return -1;
+}
+
+void SweepDialog::updateHeatmap()
+{
+    QStringList knees;
+
+    for (int row = 0; row < m_results.size(); row++) {
+        const QVector<Benchmark::Sample> &samples = m_results.at(row);
+
+        for (int column = 0; column < samples.size(); column++) {
+            const Benchmark::Sample &sample = samples.at(column);
+            double value = m_metric->currentIndex() == 0 ? sample.Bandwidth : m_metric->currentIndex() == 1 ? sample.IOPS : sample.Latency;
+            m_heatmap->setValue(row, column, value, formatValue(sample));
+            m_heatmap->setMarked(row, column, false);
+        }
+
+        if (samples.isEmpty()) continue;
+
+        int knee = kneeIndex(samples);
+
+        if (knee >= 0) {
+            const Benchmark::Sample &sample = samples.at(knee);
+            m_heatmap->setMarked(row, knee, true);
+            knees << tr("%1: knee at QD %2 (%3 IOPS, %4 MB/s, %5 μs)")
+                     .arg(Global::formatBlockSize(m_blockSizes.at(row))).arg(m_queueDepths.at(knee))
+                     .arg(sample.IOPS, 0, 'f', 0).arg(sample.Bandwidth, 0, 'f', 1).arg(sample.Latency, 0, 'f', 1);
+        }
+        else if (samples.size() == m_queueDepths.size()) {
+            knees << tr("%1: no knee up to QD %2").arg(Global::formatBlockSize(m_blockSizes.at(row))).arg(m_queueDepths.last());
+        }
+    }
+
+    m_knees->setText(knees.join('\n'));
+}
+
+bool SweepDialog::prepareRun()
+{
+    m_queueDepths = range(m_queueDepthFrom, m_queueDepthTo);
+    m_blockSizes = range(m_blockSizeFrom, m_blockSizeTo);
+    m_results = QVector<QVector<Benchmark::Sample>>(m_blockSizes.size());
+
+    QStringList columns, rows;
+    for (int queueDepth : m_queueDepths) columns << QString::number(queueDepth);
+    for (int blockSize : m_blockSizes) rows << Global::formatBlockSize(blockSize);
+
+    m_heatmap->setAxes(tr("Queue depth"), columns, tr("Block size"), rows);
+    m_knees->clear();
+
+    return true;
+}
+
+bool SweepDialog::run()
+{
+    const QString rw = m_pattern->currentData().toString();
+    const int threads = m_threads->value();
+    const int total = m_queueDepths.size() * m_blockSizes.size();
+
+    int done = 0;
+
+    for (int row = 0; row < m_blockSizes.size(); row++) {
+        for (int column = 0; column < m_queueDepths.size(); column++) {
+            updateEta(done, total);
+
+            Benchmark::PerformanceResult result;
+            Benchmark::TestSpec spec { rw, m_blockSizes.at(row), m_queueDepths.at(column), threads, {} };
+
+            if (!m_benchmark->measure(spec, result, tr("Sweep %1 Q%2 (%3/%4)").arg(Global::formatBlockSize(spec.blockSize))
+                                      .arg(spec.queueDepth).arg(done + 1).arg(total))) return false;
+
+            m_results[row].append({ result.Bandwidth, result.IOPS, result.Latency });
+            done++;
+
+            updateHeatmap();
+        }
+    }
+
+    return true;
+}
+
+bool SweepDialog::hasResults() const
+{
+    return !m_results.isEmpty() && !m_results.first().isEmpty();
+}
+
+void SweepDialog::copyResults()
+{
+    QStringList lines { QStringLiteral("block_size_kib,queue_depth,mb_s,iops,latency_us,knee") };
+
+    for (int row = 0; row < m_results.size(); row++) {
+        const QVector<Benchmark::Sample> &samples = m_results.at(row);
+        int knee = kneeIndex(samples);
+
+        for (int column = 0; column < samples.size(); column++) {
+            const Benchmark::Sample &sample = samples.at(column);
+            lines << QStringLiteral("%1,%2,%3,%4,%5,%6").arg(m_blockSizes.at(row)).arg(m_queueDepths.at(column))
+                     .arg(sample.Bandwidth, 0, 'f', 3).arg(sample.IOPS, 0, 'f', 3).arg(sample.Latency, 0, 'f', 3)
+                     .arg(column == knee ? 1 : 0);
+        }
+    }
+
+    QApplication::clipboard()->setText(lines.join('\n'));
+}
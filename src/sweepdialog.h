@@ -0,0 +1,49 @@
+#ifndef SWEEPDIALOG_H
+#define SWEEPDIALOG_H
+
+#include <QVector>
+
+#include "tooldialog.h"
+
+class QComboBox;
+class QSpinBox;
+class QLabel;
+class HeatmapWidget;
+
+// Runs every queue depth × block size combination of the chosen ranges
+// and shows the results as a heatmap with the latency knee of each block size
+class SweepDialog : public ToolDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SweepDialog(Benchmark *benchmark, QWidget *parent = nullptr);
+
+    // Last queue depth before latency grows faster than throughput, -1 if that is not reached
+    static int kneeIndex(const QVector<Benchmark::Sample> &samples);
+
+private slots:
+    void updateHeatmap();
+
+private:
+    bool prepareRun() override;
+    bool run() override;
+    bool hasResults() const override;
+    void copyResults() override;
+
+    static QVector<int> range(QComboBox *from, QComboBox *to);
+    QString formatValue(const Benchmark::Sample &sample) const;
+
+    QComboBox *m_pattern;
+    QComboBox *m_queueDepthFrom, *m_queueDepthTo;
+    QComboBox *m_blockSizeFrom, *m_blockSizeTo;
+    QSpinBox *m_threads;
+    QComboBox *m_metric;
+    HeatmapWidget *m_heatmap;
+    QLabel *m_knees;
+
+    QVector<int> m_queueDepths, m_blockSizes;
+    QVector<QVector<Benchmark::Sample>> m_results; // per block size, in queue depth order
+};
+
+#endif // SWEEPDIALOG_H
@@ -0,0 +1,46 @@
+#include "targetsdialog.h"
+
+#include <QDialogButtonBox>
+#include <QLabel>
+#include <QListWidget>
+#include <QVBoxLayout>
+
+TargetsDialog::TargetsDialog(const QVector<Global::Storage> &storages, const QStringList &selected, QWidget *parent)
+    : QDialog(parent)
+    , m_list(new QListWidget(this))
+{
+    setWindowTitle(tr("Additional Targets"));
+
+    for (const Global::Storage &storage : storages) {
+        QListWidgetItem *item = new QListWidgetItem(QStringLiteral("%1 (%2)").arg(storage.path, storage.formatedSize), m_list);
+        item->setData(Qt::UserRole, storage.path);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(selected.contains(storage.path) ? Qt::Checked : Qt::Unchecked);
+    }
+
+    QLabel *label = new QLabel(tr("The checked targets are benchmarked at the same time as the selected one. "
+                                  "Results show the aggregate, the tooltips break it down per target."), this);
+    label->setWordWrap(true);
+
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    connect(buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(label);
+    layout->addWidget(m_list);
+    layout->addWidget(buttonBox);
+}
+
+QStringList TargetsDialog::selectedDirs() const
+{
+    QStringList dirs;
+
+    for (int i = 0; i < m_list->count(); i++) {
+        if (m_list->item(i)->checkState() == Qt::Checked) {
+            dirs << m_list->item(i)->data(Qt::UserRole).toString();
+        }
+    }
+
+    return dirs;
+}
@@ -0,0 +1,24 @@
+#ifndef TARGETSDIALOG_H
+#define TARGETSDIALOG_H
+
+#include <QDialog>
+
+#include "global.h"
+
+class QListWidget;
+
+// Picks the storages that are benchmarked together with the selected one
+class TargetsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    TargetsDialog(const QVector<Global::Storage> &storages, const QStringList &selected, QWidget *parent = nullptr);
+
+    QStringList selectedDirs() const;
+
+private:
+    QListWidget *m_list;
+};
+
+#endif // TARGETSDIALOG_H
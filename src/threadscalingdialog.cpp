@@ -0,0 +1,208 @@
+#include "threadscalingdialog.h"
+
+#include <QApplication>
+#include <QCheckBox>
+#include <QClipboard>
+#include <QComboBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QRegularExpressionValidator>
+#include <QSpinBox>
+#include <QThread>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "chartwidget.h"
+
+namespace {
+// Scaling counts as linear while every thread keeps at least this share of the first point's IOPS
+constexpr double LinearityThreshold = 0.9;
+}
+
+ThreadScalingDialog::ThreadScalingDialog(Benchmark *benchmark, QWidget *parent)
+    : ToolDialog(benchmark, parent)
+    , m_pattern(createPatternCombo())
+    , m_blockSize(createBlockSizeCombo())
+    , m_queueDepth(createQueueDepthCombo())
+    , m_maxThreads(new QSpinBox(this))
+    , m_powersOfTwo(new QCheckBox(tr("Powers of two only"), this))
+    , m_cpus(new QLineEdit(this))
+    , m_chart(new ChartWidget(this))
+    , m_table(new QTreeWidget(this))
+    , m_summary(new QLabel(this))
+{
+    setWindowTitle(tr("Thread Scaling"));
+
+    const int cpuCount = qMax(1, QThread::idealThreadCount());
+
+    m_maxThreads->setRange(1, 256);
+    m_maxThreads->setValue(cpuCount);
+    m_powersOfTwo->setChecked(true);
+
+    m_cpus->setText(cpuCount > 1 ? QStringLiteral("0-%1").arg(cpuCount - 1) : QStringLiteral("0"));
+    m_cpus->setPlaceholderText(tr("Not pinned"));
+    m_cpus->setToolTip(tr("Every thread is pinned to its own CPU of this list, e.g. 0-7,16-23. Leave empty to let the scheduler decide."));
+    m_cpus->setValidator(new QRegularExpressionValidator(QRegularExpression(QStringLiteral("^(\\d+(-\\d+)?(,\\d+(-\\d+)?)*)?$")), this));
+
+    m_chart->setAxisTitles(tr("Threads"), tr("IOPS per thread"));
+
+    m_table->setRootIsDecorated(false);
+    m_table->setHeaderLabels({ tr("Threads"), tr("IOPS"), tr("IOPS per thread"), tr("Efficiency"), tr("MB/s"), tr("μs") });
+
+    m_summary->setWordWrap(true);
+
+    QHBoxLayout *threadsLayout = new QHBoxLayout;
+    threadsLayout->addWidget(m_maxThreads);
+    threadsLayout->addWidget(m_powersOfTwo);
+
+    QFormLayout *formLayout = new QFormLayout;
+    formLayout->addRow(tr("Pattern:"), m_pattern);
+    formLayout->addRow(tr("Block size:"), m_blockSize);
+    formLayout->addRow(tr("Queue depth per thread:"), m_queueDepth);
+    formLayout->addRow(tr("Threads up to:"), threadsLayout);
+    formLayout->addRow(tr("CPUs:"), m_cpus);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(formLayout);
+    layout->addWidget(m_chart, 1);
+    layout->addWidget(m_table);
+    layout->addWidget(m_summary);
+    layout->addLayout(createButtonLayout());
+
+    m_inputs = { m_pattern, m_blockSize, m_queueDepth, m_maxThreads, m_powersOfTwo, m_cpus };
+}
+
+double ThreadScalingDialog::efficiency(int index) const
+{
+    double base = m_results.first().IOPS / m_threads.first();
+    return base > 0 ? m_results.at(index).IOPS / m_threads.at(index) / base : 0;
+}
+
+int ThreadScalingDialog::nonlinearIndex(const QVector<int> &threads, const QVector<Benchmark::Sample> &samples)
+{
+    if (samples.isEmpty() || samples.first().IOPS <= 0) return -1;
+
+    const double base = samples.first().IOPS / threads.first();
+
+    for (int i = 1; i < samples.size(); i++) {
+        if (samples.at(i).IOPS / threads.at(i) < base * LinearityThreshold) return i;
+    }
+
+    return -1;
+}
+
+void ThreadScalingDialog::updateResults()
+{
+    QVector<QPointF> measured, linear;
+
+    m_table->clear();
+
+    for (int i = 0; i < m_results.size(); i++) {
+        const Benchmark::Sample &sample = m_results.at(i);
+
+        measured << QPointF(m_threads.at(i), sample.IOPS / m_threads.at(i));
+        linear << QPointF(m_threads.at(i), m_results.first().IOPS / m_threads.first());
+
+        m_table->addTopLevelItem(new QTreeWidgetItem({
+            QString::number(m_threads.at(i)),
+            QString::number(sample.IOPS, 'f', 0),
+            QString::number(sample.IOPS / m_threads.at(i), 'f', 0),
+            QStringLiteral("%1%").arg(efficiency(i) * 100, 0, 'f', 0),
+            QString::number(sample.Bandwidth, 'f', 1),
+            QString::number(sample.Latency, 'f', 1)
+        }));
+    }
+
+    m_chart->clear();
+    m_chart->setSeries(tr("Measured"), measured);
+    m_chart->setSeries(tr("Linear"), linear);
+
+    int index = nonlinearIndex(m_threads, m_results);
+
+    if (index >= 0) {
+        float bestIOPS = 0;
+        for (const Benchmark::Sample &sample : m_results) bestIOPS = qMax(bestIOPS, sample.IOPS);
+
+        m_table->topLevelItem(index)->setForeground(3, Qt::red);
+        m_summary->setText(tr("Scaling stops being linear at %1 threads: each thread keeps %2% of the IOPS per thread at %3, "
+                              "the best total was %4 IOPS.")
+                           .arg(m_threads.at(index)).arg(efficiency(index) * 100, 0, 'f', 0).arg(m_threads.first())
+                           .arg(bestIOPS, 0, 'f', 0));
+    }
+    else if (m_results.size() > 1) {
+        m_summary->setText(tr("Scaling stays linear up to %1 threads.").arg(m_threads.at(m_results.size() - 1)));
+    }
+    else {
+        m_summary->clear();
+    }
+}
+
+bool ThreadScalingDialog::prepareRun()
+{
+    m_threads.clear();
+    m_results.clear();
+
+    const bool powersOfTwo = m_powersOfTwo->isChecked();
+
+    for (int i = 1; i <= m_maxThreads->value(); i = powersOfTwo ? i * 2 : i + 1) {
+        m_threads << i;
+    }
+
+    if (m_threads.last() != m_maxThreads->value()) {
+        m_threads << m_maxThreads->value();
+    }
+
+    updateResults();
+
+    return true;
+}
+
+bool ThreadScalingDialog::run()
+{
+    QVariantMap options;
+
+    // With split every job gets its own CPU of the set, jobs beyond its size wrap around
+    if (!m_cpus->text().isEmpty()) {
+        options["cpus_allowed"] = m_cpus->text();
+        options["cpus_allowed_policy"] = "split";
+    }
+
+    const QString rw = m_pattern->currentData().toString();
+    const int blockSize = m_blockSize->currentData().toInt();
+    const int queueDepth = m_queueDepth->currentData().toInt();
+
+    for (int i = 0; i < m_threads.size(); i++) {
+        updateEta(i, m_threads.size());
+
+        Benchmark::PerformanceResult result;
+        if (!m_benchmark->measure({ rw, blockSize, queueDepth, m_threads.at(i), options }, result,
+                                  tr("Thread Scaling T%1 (%2/%3)").arg(m_threads.at(i)).arg(i + 1).arg(m_threads.size()))) return false;
+
+        m_results.append({ result.Bandwidth, result.IOPS, result.Latency });
+
+        updateResults();
+    }
+
+    return true;
+}
+
+bool ThreadScalingDialog::hasResults() const
+{
+    return !m_results.isEmpty();
+}
+
+void ThreadScalingDialog::copyResults()
+{
+    QStringList lines { QStringLiteral("threads,iops,iops_per_thread,efficiency,mb_s,latency_us") };
+
+    for (int i = 0; i < m_results.size(); i++) {
+        const Benchmark::Sample &sample = m_results.at(i);
+        lines << QStringLiteral("%1,%2,%3,%4,%5,%6").arg(m_threads.at(i))
+                 .arg(sample.IOPS, 0, 'f', 3).arg(sample.IOPS / m_threads.at(i), 0, 'f', 3).arg(efficiency(i), 0, 'f', 3)
+                 .arg(sample.Bandwidth, 0, 'f', 3).arg(sample.Latency, 0, 'f', 3);
+    }
+
+    QApplication::clipboard()->setText(lines.join('\n'));
+}
@@ -0,0 +1,51 @@
+#ifndef THREADSCALINGDIALOG_H
+#define THREADSCALINGDIALOG_H
+
+#include <QVector>
+
+#include "tooldialog.h"
+
+class QCheckBox;
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QSpinBox;
+class QTreeWidget;
+class ChartWidget;
+
+// Runs the same job with a growing number of threads, each pinned to its own CPU
+// of the chosen set, and shows how IOPS per thread hold up
+class ThreadScalingDialog : public ToolDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ThreadScalingDialog(Benchmark *benchmark, QWidget *parent = nullptr);
+
+    // First point whose IOPS per thread fall below the linearity threshold of the first point, -1 if none
+    static int nonlinearIndex(const QVector<int> &threads, const QVector<Benchmark::Sample> &samples);
+
+private:
+    bool prepareRun() override;
+    bool run() override;
+    bool hasResults() const override;
+    void copyResults() override;
+
+    void updateResults();
+    double efficiency(int index) const;
+
+    QComboBox *m_pattern;
+    QComboBox *m_blockSize;
+    QComboBox *m_queueDepth;
+    QSpinBox *m_maxThreads;
+    QCheckBox *m_powersOfTwo;
+    QLineEdit *m_cpus;
+    ChartWidget *m_chart;
+    QTreeWidget *m_table;
+    QLabel *m_summary;
+
+    QVector<int> m_threads;
+    QVector<Benchmark::Sample> m_results;
+};
+
+#endif // THREADSCALINGDIALOG_H
@@ -0,0 +1,134 @@
+#include "tooldialog.h"
+
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+
+#include "appsettings.h"
+#include "global.h"
+
+ToolDialog::ToolDialog(Benchmark *benchmark, QWidget *parent)
+    : QDialog(parent)
+    , m_benchmark(benchmark)
+    , m_startButton(new QPushButton(tr("Start"), this))
+    , m_status(new QLabel(this))
+{
+    connect(m_startButton, &QPushButton::clicked, this, &ToolDialog::start);
+
+    // Only the dialog's own run can be stopped from here
+    connect(m_benchmark, &Benchmark::runningStateChanged, this, [this] (bool state) {
+        if (!m_running) m_startButton->setEnabled(!state && canStart());
+    });
+}
+
+QComboBox *ToolDialog::createPatternCombo()
+{
+    QComboBox *combo = new QComboBox(this);
+
+    combo->addItem(tr("Random Read"), Global::getRWRandomRead());
+    combo->addItem(tr("Random Write"), Global::getRWRandomWrite());
+    combo->addItem(tr("Random Mix"), Global::getRWRandomMix());
+    combo->addItem(tr("Sequential Read"), Global::getRWSequentialRead());
+    combo->addItem(tr("Sequential Write"), Global::getRWSequentialWrite());
+    combo->addItem(tr("Sequential Mix"), Global::getRWSequentialMix());
+
+    return combo;
+}
+
+QComboBox *ToolDialog::createBlockSizeCombo(int current, int largest)
+{
+    QComboBox *combo = new QComboBox(this);
+
+    for (int i = 4; i <= largest; i *= 2) {
+        combo->addItem(Global::formatBlockSize(i), i);
+    }
+
+    combo->setCurrentIndex(combo->findData(current));
+
+    return combo;
+}
+
+QComboBox *ToolDialog::createQueueDepthCombo(int current)
+{
+    QComboBox *combo = new QComboBox(this);
+
+    for (int i = 1; i <= 512; i *= 2) {
+        combo->addItem(QString::number(i), i);
+    }
+
+    combo->setCurrentIndex(combo->findData(current));
+
+    return combo;
+}
+
+QHBoxLayout *ToolDialog::createButtonLayout(bool copyable)
+{
+    QHBoxLayout *buttonLayout = new QHBoxLayout;
+    buttonLayout->addWidget(m_status, 1);
+
+    if (copyable) {
+        m_copyButton = new QPushButton(tr("Copy"), this);
+        m_copyButton->setEnabled(false);
+        connect(m_copyButton, &QPushButton::clicked, this, &ToolDialog::copyResults);
+
+        buttonLayout->addWidget(m_copyButton);
+    }
+
+    buttonLayout->addWidget(m_startButton);
+
+    return buttonLayout;
+}
+
+void ToolDialog::updateEta(int done, int total)
+{
+    qint64 perStep = done > 0 ? m_timer.elapsed() / done : AppSettings().getMeasuringTime() * 1000;
+    m_status->setText(tr("Running %1 of %2, about %3 left").arg(done + 1).arg(total)
+                      .arg(Global::formatDuration(perStep * (total - done))));
+}
+
+void ToolDialog::setInputsEnabled(bool enabled)
+{
+    for (QWidget *widget : m_inputs) {
+        widget->setEnabled(enabled);
+    }
+}
+
+void ToolDialog::start()
+{
+    if (m_running) {
+        m_benchmark->setRunning(false);
+        return;
+    }
+
+    if (m_benchmark->getBenchmarkFile().isNull()) {
+        QMessageBox::critical(this, tr("Not available"), tr("Directory is not specified."));
+        return;
+    }
+
+    if (!prepareRun()) return;
+
+    if (m_copyButton) m_copyButton->setEnabled(false);
+    setInputsEnabled(false);
+
+    const QString startText = m_startButton->text();
+
+    m_running = true;
+    m_startButton->setText(tr("Stop"));
+
+    bool finished = false;
+
+    m_benchmark->runTool([&] {
+        m_timer.start();
+
+        finished = run();
+    });
+
+    m_status->setText(finished ? tr("Finished in %1").arg(Global::formatDuration(m_timer.elapsed())) : tr("Stopped"));
+    m_running = false;
+    m_startButton->setText(startText);
+    if (m_copyButton) m_copyButton->setEnabled(hasResults());
+
+    setInputsEnabled(true);
+}
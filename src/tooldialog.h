@@ -0,0 +1,63 @@
+#ifndef TOOLDIALOG_H
+#define TOOLDIALOG_H
+
+#include <QDialog>
+#include <QElapsedTimer>
+#include <QList>
+
+#include "benchmark.h"
+
+class QComboBox;
+class QHBoxLayout;
+class QLabel;
+class QPushButton;
+
+// Base of the tool dialogs: one run at a time started and stopped from the start button,
+// the inputs locked while it goes on and its progress and outcome in the status label
+class ToolDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ToolDialog(Benchmark *benchmark, QWidget *parent = nullptr);
+
+protected slots:
+    void start();
+    virtual void copyResults() {}
+
+protected:
+    // Combos with the choices of the test settings
+    QComboBox *createPatternCombo();
+    QComboBox *createBlockSizeCombo(int current = 4, int largest = 8192);
+    QComboBox *createQueueDepthCombo(int current = 32);
+
+    // Status, copy and start button in a row, the copy button is left out unless copyable
+    QHBoxLayout *createButtonLayout(bool copyable = true);
+
+    // Step done + 1 of total with the time left, estimated from the steps so far or, before the first, the measuring time
+    void updateEta(int done, int total);
+
+    // Locks the inputs while running, all of m_inputs by default
+    virtual void setInputsEnabled(bool enabled);
+
+    // Whether a run can be started once the benchmark is idle
+    virtual bool canStart() const { return true; }
+    // Checks the dialog's own preconditions and clears the previous results, false when it cannot start
+    virtual bool prepareRun() { return true; }
+    // Issues the measurements inside Benchmark::runTool, false when the run was stopped or failed
+    virtual bool run() = 0;
+    virtual bool hasResults() const { return false; }
+
+    Benchmark *m_benchmark;
+
+    QPushButton *m_startButton;
+    QPushButton *m_copyButton = nullptr;
+    QLabel *m_status;
+    QList<QWidget*> m_inputs;
+
+    bool m_running = false;
+    // Started once the benchmark file is prepared, so preparation does not skew the estimate
+    QElapsedTimer m_timer;
+};
+
+#endif // TOOLDIALOG_H
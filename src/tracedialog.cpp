@@ -0,0 +1,181 @@
+#include "tracedialog.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QComboBox>
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "global.h"
+
+TraceDialog::TraceDialog(Benchmark *benchmark, QWidget *parent)
+    : ToolDialog(benchmark, parent)
+    , m_file(new QLineEdit(this))
+    , m_browseButton(new QPushButton(tr("Browse..."), this))
+    , m_speed(new QComboBox(this))
+    , m_queueDepth(createQueueDepthCombo())
+    , m_table(new QTreeWidget(this))
+{
+    setWindowTitle(tr("Trace Replay"));
+
+    m_file->setToolTip(tr("blktrace output merged with blkparse -d, or a fio iolog, e.g. from fio --write_iolog"));
+
+    m_speed->addItem(tr("Original timing"), 100);
+    m_speed->addItem(tr("Half speed"), 50);
+    m_speed->addItem(tr("2× faster"), 200);
+    m_speed->addItem(tr("4× faster"), 400);
+    m_speed->addItem(tr("10× faster"), 1000);
+    m_speed->addItem(tr("As fast as possible"), 0);
+
+    m_queueDepth->setToolTip(tr("Most requests in flight at once, requests due later wait for a free slot"));
+
+    m_table->setRootIsDecorated(false);
+    m_table->setHeaderLabels({ QString(), tr("Original"), tr("Replay") });
+
+    QHBoxLayout *fileLayout = new QHBoxLayout;
+    fileLayout->addWidget(m_file, 1);
+    fileLayout->addWidget(m_browseButton);
+
+    QFormLayout *formLayout = new QFormLayout;
+    formLayout->addRow(tr("Trace:"), fileLayout);
+    formLayout->addRow(tr("Speed:"), m_speed);
+    formLayout->addRow(tr("Queue depth:"), m_queueDepth);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(formLayout);
+    layout->addWidget(m_table, 1);
+    layout->addLayout(createButtonLayout());
+
+    connect(m_browseButton, &QPushButton::clicked, this, &TraceDialog::browse);
+
+    m_inputs = { m_file, m_browseButton, m_speed, m_queueDepth };
+}
+
+void TraceDialog::browse()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Open a Trace"), m_file->text());
+    if (!fileName.isEmpty()) m_file->setText(fileName);
+}
+
+double TraceDialog::mean(const LatencyHistogram &histogram)
+{
+    if (histogram.isEmpty()) return 0;
+
+    double sum = 0;
+    for (unsigned i = 0; i < LatencyHistogram::BucketCount; i++) {
+        sum += double(histogram.bucket(i)) * LatencyHistogram::bucketValue(i);
+    }
+
+    return sum / histogram.count();
+}
+
+void TraceDialog::updateResults()
+{
+    m_table->clear();
+
+    if (m_summary.isEmpty()) return;
+
+    const QString none = QStringLiteral("–");
+
+    const Benchmark::PerformanceResult &read = m_replay.read;
+    const Benchmark::PerformanceResult &write = m_replay.write;
+
+    LatencyHistogram replay = read.Histogram;
+    replay.merge(write.Histogram);
+
+    const double replayIOPS = read.IOPS + write.IOPS;
+    const double replayMean = replayIOPS > 0 ? (read.Latency * read.IOPS + write.Latency * write.IOPS) / replayIOPS : 0;
+
+    auto addRow = [this] (const QString &name, const QString &original, const QString &replay) {
+        m_table->addTopLevelItem(new QTreeWidgetItem({ name, original, replay }));
+    };
+
+    addRow(tr("Requests"), tr("%1 (%2 reads, %3 writes, %4 syncs)").arg(m_summary["ios"].toULongLong())
+           .arg(m_summary["reads"].toULongLong()).arg(m_summary["writes"].toULongLong()).arg(m_summary["syncs"].toULongLong()),
+           m_replayed ? QString::number(replayIOPS * m_replay.runtime / 1000, 'f', 0) : none);
+    addRow(tr("Duration"), Global::formatDuration(m_summary["duration"].toLongLong()),
+           m_replayed ? Global::formatDuration(qint64(m_replay.runtime)) : none);
+    addRow(tr("IOPS"), m_summary["duration"].toLongLong() > 0
+           ? QString::number(m_summary["ios"].toDouble() * 1000 / m_summary["duration"].toDouble(), 'f', 0) : none,
+           m_replayed ? QString::number(replayIOPS, 'f', 0) : none);
+    addRow(tr("MB/s"), m_summary["duration"].toLongLong() > 0
+           ? QString::number(m_summary["bytes"].toDouble() / 1000 / m_summary["duration"].toDouble(), 'f', 1) : none,
+           m_replayed ? QString::number(read.Bandwidth + write.Bandwidth, 'f', 1) : none);
+    addRow(tr("Mean μs"), m_original.isEmpty() ? none : QString::number(mean(m_original) / 1000, 'f', 1),
+           m_replayed ? QString::number(replayMean, 'f', 1) : none);
+
+    for (double percent : Global::getLatencyPercentiles()) {
+        addRow(tr("p%1 μs").arg(percent), m_original.isEmpty() ? none : QString::number(m_original.percentile(percent) / 1000.0, 'f', 1),
+               m_replayed && !replay.isEmpty() ? QString::number(replay.percentile(percent) / 1000.0, 'f', 1) : none);
+    }
+
+    for (int i = 0; i < m_table->columnCount(); i++) {
+        m_table->resizeColumnToContents(i);
+    }
+}
+
+bool TraceDialog::prepareRun()
+{
+    if (m_file->text().isEmpty()) {
+        QMessageBox::critical(this, tr("Not available"), tr("No trace is selected."));
+        return false;
+    }
+
+    m_summary.clear();
+    m_original.clear();
+    m_replayed = false;
+
+    updateResults();
+
+    return true;
+}
+
+bool TraceDialog::run()
+{
+    m_status->setText(tr("Loading the trace"));
+
+    if (!m_benchmark->loadTrace(m_file->text(), m_speed->currentData().toInt(), m_summary)) return false;
+
+    const QVariantMap bins = m_summary["originalLatency"].toMap();
+    for (auto it = bins.constBegin(); it != bins.constEnd(); ++it) {
+        m_original.add(LatencyHistogram::bucketValue(it.key().toUInt()), it.value().toULongLong());
+    }
+
+    updateResults();
+
+    m_status->setText(tr("Replaying %1 requests").arg(m_summary["ios"].toULongLong()));
+
+    // The trace decides pattern, sizes and length
+    Benchmark::TestSpec spec { QStringLiteral("trace"), 4, m_queueDepth->currentData().toInt(), 1, {} };
+    spec.measuringTime = -1;
+
+    m_replayed = m_benchmark->measure(spec, m_replay, tr("Trace Replay"));
+
+    updateResults();
+
+    return m_replayed;
+}
+
+bool TraceDialog::hasResults() const
+{
+    return m_replayed;
+}
+
+void TraceDialog::copyResults()
+{
+    QStringList lines { QStringLiteral("metric,original,replay") };
+
+    for (int i = 0; i < m_table->topLevelItemCount(); i++) {
+        const QTreeWidgetItem *item = m_table->topLevelItem(i);
+        lines << QStringLiteral("\"%1\",\"%2\",\"%3\"").arg(item->text(0), item->text(1), item->text(2));
+    }
+
+    QApplication::clipboard()->setText(lines.join('\n'));
+}
@@ -0,0 +1,47 @@
+#ifndef TRACEDIALOG_H
+#define TRACEDIALOG_H
+
+#include <QVariantMap>
+
+#include "latencyhistogram.h"
+#include "tooldialog.h"
+
+class QComboBox;
+class QLineEdit;
+class QPushButton;
+class QTreeWidget;
+
+// Replays a recorded block trace on the benchmark target, with its timing kept or sped up,
+// and sets the latency achieved against the latency of the original run
+class TraceDialog : public ToolDialog
+{
+    Q_OBJECT
+
+public:
+    explicit TraceDialog(Benchmark *benchmark, QWidget *parent = nullptr);
+
+private slots:
+    void browse();
+
+private:
+    bool prepareRun() override;
+    bool run() override;
+    bool hasResults() const override;
+    void copyResults() override;
+
+    void updateResults();
+    static double mean(const LatencyHistogram &histogram);
+
+    QLineEdit *m_file;
+    QPushButton *m_browseButton;
+    QComboBox *m_speed;
+    QComboBox *m_queueDepth;
+    QTreeWidget *m_table;
+
+    bool m_replayed = false;
+    QVariantMap m_summary;
+    LatencyHistogram m_original;
+    Benchmark::ParsedJob m_replay;
+};
+
+#endif // TRACEDIALOG_H
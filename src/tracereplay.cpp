@@ -0,0 +1,285 @@
+#include "tracereplay.h"
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QList>
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <utility>
+
+namespace {
+
+// Requests are aligned for O_DIRECT on 4K sector devices
+constexpr uint64_t Alignment = 4096;
+// fio drops shorter waits, so they are carried over to the next one instead
+constexpr uint64_t MinWaitUs = 100;
+// Longest file name fio parses from an iolog line
+constexpr int MaxFileNameLength = 256;
+
+// From linux/blktrace_api.h
+constexpr uint32_t BlkMagic = 0x65617400;
+constexpr uint32_t BlkActionQueue = 1;
+constexpr uint32_t BlkActionIssue = 7;
+constexpr uint32_t BlkActionComplete = 8;
+constexpr uint32_t BlkCategoryWrite = 1 << 1;
+constexpr uint32_t BlkCategoryFlush = 1 << 2;
+constexpr uint32_t BlkCategoryDiscard = 1 << 13;
+
+struct BlkIoTrace
+{
+    uint32_t magic;
+    uint32_t sequence;
+    uint64_t time; // ns
+    uint64_t sector;
+    uint32_t bytes;
+    uint32_t action;
+    uint32_t pid;
+    uint32_t device;
+    uint16_t cpu;
+    uint16_t error;
+    uint16_t pduLength;
+};
+static_assert(sizeof(BlkIoTrace) == 48, "blktrace records are 48 bytes");
+
+enum class Action {
+    Read,
+    Write,
+    Sync
+};
+
+class IologWriter
+{
+public:
+    IologWriter(QIODevice &out, const QString &fileName, uint64_t fileSize, int speed, TraceReplay::Summary &summary)
+        : m_out(out), m_fileName(fileName.toUtf8()), m_fileSize(fileSize - fileSize % Alignment), m_speed(speed), m_summary(summary)
+    {
+        write("fio version 2 iolog\n" + m_fileName + " add\n" + m_fileName + " open\n");
+    }
+
+    void request(uint64_t timeNs, Action action, uint64_t offset, uint64_t length)
+    {
+        if (!m_started) {
+            m_started = true;
+            m_firstNs = m_lastNs = timeNs;
+        }
+
+        // Out of order records are replayed right away
+        if (timeNs > m_lastNs) {
+            if (m_speed > 0) m_pendingNs += (timeNs - m_lastNs) * 100 / uint64_t(m_speed);
+            m_lastNs = timeNs;
+            m_summary.durationNs = timeNs - m_firstNs;
+        }
+
+        if (m_pendingNs >= MinWaitUs * 1000) {
+            write(m_fileName + " wait " + QByteArray::number(qulonglong(m_pendingNs / 1000)) + " 0\n");
+            m_pendingNs %= 1000;
+        }
+
+        if (action == Action::Sync) {
+            write(m_fileName + " sync 0 0\n");
+            m_summary.syncs++;
+            return;
+        }
+
+        // Requests of another file or device land at the same relative place of the benchmark file
+        length = std::min((length + Alignment - 1) / Alignment * Alignment, m_fileSize);
+        if (length == 0) return;
+
+        const uint64_t lastStart = m_fileSize - length;
+        offset = (offset % (lastStart + 1)) / Alignment * Alignment;
+
+        write(m_fileName + (action == Action::Write ? " write " : " read ") +
+              QByteArray::number(qulonglong(offset)) + ' ' + QByteArray::number(qulonglong(length)) + '\n');
+
+        m_summary.ios++;
+        m_summary.bytes += length;
+        (action == Action::Write ? m_summary.writes : m_summary.reads)++;
+    }
+
+    QString finish()
+    {
+        write(m_fileName + " close\n");
+
+        if (!m_error.isEmpty()) return m_error;
+        if (m_summary.ios == 0) return QStringLiteral("The trace has no read or write requests.");
+        return {};
+    }
+
+private:
+    void write(const QByteArray &line)
+    {
+        if (m_error.isEmpty() && m_out.write(line) != line.size()) {
+            m_error = QStringLiteral("Cannot write the replay log: %1").arg(m_out.errorString());
+        }
+    }
+
+    QIODevice &m_out;
+    const QByteArray m_fileName;
+    const uint64_t m_fileSize;
+    const int m_speed;
+    TraceReplay::Summary &m_summary;
+
+    bool m_started = false;
+    uint64_t m_firstNs = 0;
+    uint64_t m_lastNs = 0;
+    uint64_t m_pendingNs = 0;
+    QString m_error;
+};
+
+void swapRecord(BlkIoTrace &record)
+{
+    record.magic = __builtin_bswap32(record.magic);
+    record.sequence = __builtin_bswap32(record.sequence);
+    record.time = __builtin_bswap64(record.time);
+    record.sector = __builtin_bswap64(record.sector);
+    record.bytes = __builtin_bswap32(record.bytes);
+    record.action = __builtin_bswap32(record.action);
+    record.pid = __builtin_bswap32(record.pid);
+    record.device = __builtin_bswap32(record.device);
+    record.cpu = __builtin_bswap16(record.cpu);
+    record.error = __builtin_bswap16(record.error);
+    record.pduLength = __builtin_bswap16(record.pduLength);
+}
+
+QString convertBlktrace(QIODevice &trace, IologWriter &writer, TraceReplay::Summary &summary)
+{
+    // Requests in flight by device and sector, to time them from issue to completion
+    std::map<std::pair<uint32_t, uint64_t>, uint64_t> issued;
+    bool swapped = false;
+    bool first = true;
+
+    BlkIoTrace record;
+
+    while (trace.read(reinterpret_cast<char*>(&record), sizeof(record)) == sizeof(record)) {
+        if (first) {
+            swapped = (record.magic & 0xffffff00) != BlkMagic;
+            first = false;
+        }
+
+        if (swapped) swapRecord(record);
+
+        if ((record.magic & 0xffffff00) != BlkMagic) {
+            return QStringLiteral("The blktrace data is damaged or was not merged with blkparse -d.");
+        }
+
+        if (record.pduLength > 0 && trace.skip(record.pduLength) != record.pduLength) break;
+
+        const uint32_t what = record.action & 0xffff;
+        const uint32_t category = record.action >> 16;
+
+        if (category & BlkCategoryDiscard) continue;
+
+        const auto key = std::make_pair(record.device, record.sector);
+
+        switch (what)
+        {
+            case BlkActionQueue:
+                if (record.bytes > 0) {
+                    writer.request(record.time, category & BlkCategoryWrite ? Action::Write : Action::Read, record.sector * 512, record.bytes);
+                }
+                else if (category & BlkCategoryFlush) {
+                    writer.request(record.time, Action::Sync, 0, 0);
+                }
+                break;
+            case BlkActionIssue:
+                if (record.bytes > 0) issued[key] = record.time;
+                break;
+            case BlkActionComplete: {
+                auto it = issued.find(key);
+                if (it == issued.end()) break;
+                if (record.time > it->second) summary.originalLatency.add(record.time - it->second);
+                issued.erase(it);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    return {};
+}
+
+QString convertIolog(QIODevice &trace, int version, IologWriter &writer)
+{
+    uint64_t timeNs = 0;
+
+    while (!trace.atEnd()) {
+        QList<QByteArray> fields = trace.readLine(4096).simplified().split(' ');
+
+        // Version 3 puts a timestamp in ms before every entry
+        if (version == 3) {
+            if (fields.size() < 3) continue;
+            timeNs = fields.takeFirst().toULongLong() * 1000000;
+        }
+
+        if (fields.size() < 4) continue; // add, open and close of a file
+
+        const QByteArray &action = fields.at(1);
+        const uint64_t offset = fields.at(2).toULongLong();
+        const uint64_t length = fields.at(3).toULongLong();
+
+        if (action == "wait") {
+            if (version == 2) timeNs += offset * 1000;
+        }
+        else if (action == "read") {
+            writer.request(timeNs, Action::Read, offset, length);
+        }
+        else if (action == "write") {
+            writer.request(timeNs, Action::Write, offset, length);
+        }
+        else if (action == "sync" || action == "datasync") {
+            writer.request(timeNs, Action::Sync, 0, 0);
+        }
+        // Trims are left out, they would punch holes into the benchmark file
+    }
+
+    return {};
+}
+
+}
+
+QString TraceReplay::convert(QIODevice &trace, const QString &fileName, uint64_t fileSize, int speed,
+                             QIODevice &iolog, Summary &summary)
+{
+    summary = Summary();
+
+    if (fileSize < Alignment) {
+        return QStringLiteral("The benchmark target is too small for a replay.");
+    }
+
+    // fio reads the file name of every line with sscanf("%256s"), which stops at whitespace
+    if (fileName.toUtf8().size() > MaxFileNameLength || fileName.contains(QRegularExpression(QStringLiteral("\\s")))) {
+        return QStringLiteral("The replay target %1 has whitespace or is too long for an iolog.").arg(fileName);
+    }
+
+    const QByteArray head = trace.peek(32);
+
+    int version = 0;
+    if (head.startsWith("fio version 2 iolog")) version = 2;
+    else if (head.startsWith("fio version 3 iolog")) version = 3;
+
+    uint32_t magic = 0;
+    if (head.size() >= 4) memcpy(&magic, head.constData(), sizeof(magic));
+    const bool blktrace = (magic & 0xffffff00) == BlkMagic || (__builtin_bswap32(magic) & 0xffffff00) == BlkMagic;
+
+    if (!version && !blktrace) {
+        return QStringLiteral("Unknown trace format, expected blktrace binary data or a fio iolog of version 2 or 3.");
+    }
+
+    IologWriter writer(iolog, fileName, fileSize, speed, summary);
+
+    QString error;
+    if (version) {
+        trace.readLine(4096);
+        error = convertIolog(trace, version, writer);
+    }
+    else {
+        error = convertBlktrace(trace, writer, summary);
+    }
+
+    QString finishError = writer.finish();
+    return !error.isEmpty() ? error : finishError;
+}
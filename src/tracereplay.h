@@ -0,0 +1,35 @@
+#ifndef TRACEREPLAY_H
+#define TRACEREPLAY_H
+
+#include <QString>
+
+#include "latencyhistogram.h"
+
+class QIODevice;
+
+// Turns a recorded block trace into a fio iolog (version 2) that replays it on the benchmark file.
+// Accepted input is blktrace binary output merged into one file (blkparse -d) and fio iologs of
+// version 2 or 3, e.g. from fio --write_iolog. Whatever files or devices the trace names, every
+// request is mapped into the benchmark file, so replay never touches anything else.
+namespace TraceReplay
+{
+    struct Summary
+    {
+        uint64_t ios = 0;
+        uint64_t reads = 0;
+        uint64_t writes = 0;
+        uint64_t syncs = 0;
+        uint64_t bytes = 0;
+        uint64_t durationNs = 0; // first to last request, at the original timing
+        // Issue to completion times of the original requests, only blktrace records them
+        LatencyHistogram originalLatency;
+    };
+
+    // speed is in percent of the original rate, 0 replays as fast as possible. fileName is written
+    // on every line of the log, so it must be free of whitespace and at most 256 bytes long.
+    // Returns an empty string on success, the reason otherwise.
+    QString convert(QIODevice &trace, const QString &fileName, uint64_t fileSize, int speed,
+                    QIODevice &iolog, Summary &summary);
+}
+
+#endif // TRACEREPLAY_H
@@ -0,0 +1,423 @@
+#include "uringengine.h"
+
+#include <linux/io_uring.h>
+
+#include <sys/mman.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <random>
+
+namespace {
+
+uint64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+class Ring
+{
+public:
+    ~Ring()
+    {
+        if (m_sqes != MAP_FAILED) munmap(m_sqes, m_sqesSize);
+        if (m_cqPtr != MAP_FAILED && m_cqPtr != m_sqPtr) munmap(m_cqPtr, m_cqSize);
+        if (m_sqPtr != MAP_FAILED) munmap(m_sqPtr, m_sqSize);
+        if (m_fd >= 0) close(m_fd);
+    }
+
+    int init(unsigned entries)
+    {
+        io_uring_params p;
+        memset(&p, 0, sizeof(p));
+
+        m_fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+        if (m_fd < 0) return -errno;
+
+        m_sqSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        m_cqSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+
+        if (p.features & IORING_FEAT_SINGLE_MMAP) {
+            m_sqSize = m_cqSize = std::max(m_sqSize, m_cqSize);
+        }
+
+        m_sqPtr = mmap(nullptr, m_sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+        if (m_sqPtr == MAP_FAILED) return -errno;
+
+        if (p.features & IORING_FEAT_SINGLE_MMAP) {
+            m_cqPtr = m_sqPtr;
+        }
+        else {
+            m_cqPtr = mmap(nullptr, m_cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+            if (m_cqPtr == MAP_FAILED) return -errno;
+        }
+
+        m_sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+        m_sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+        if (m_sqes == MAP_FAILED) return -errno;
+
+        auto *sq = static_cast<char*>(m_sqPtr);
+        m_sqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        m_sqMask = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        m_sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+
+        auto *cq = static_cast<char*>(m_cqPtr);
+        m_cqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        m_cqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        m_cqMask = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+        m_localTail = *m_sqTail;
+
+        return 0;
+    }
+
+    int registerBuffers(const iovec *iovecs, unsigned count)
+    {
+        return syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS, iovecs, count) < 0 ? -errno : 0;
+    }
+
+    int registerFile(int fd)
+    {
+        return syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_FILES, &fd, 1) < 0 ? -errno : 0;
+    }
+
+    // The caller never keeps more entries in flight than the ring was set up with
+    io_uring_sqe *nextSqe()
+    {
+        unsigned index = m_localTail & m_sqMask;
+        io_uring_sqe *sqe = &static_cast<io_uring_sqe*>(m_sqes)[index];
+        memset(sqe, 0, sizeof(*sqe));
+        m_sqArray[index] = index;
+        m_localTail++;
+        return sqe;
+    }
+
+    int submitAndWait(unsigned toSubmit, unsigned waitNr)
+    {
+        __atomic_store_n(m_sqTail, m_localTail, __ATOMIC_RELEASE);
+
+        int ret;
+        do {
+            ret = (int)syscall(__NR_io_uring_enter, m_fd, toSubmit, waitNr, IORING_ENTER_GETEVENTS, nullptr, 0);
+        } while (ret < 0 && errno == EINTR);
+
+        return ret < 0 ? -errno : ret;
+    }
+
+    template <typename Func>
+    void reap(Func func)
+    {
+        unsigned head = *m_cqHead;
+        unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+
+        for (; head != tail; head++) {
+            func(m_cqes[head & m_cqMask]);
+        }
+
+        __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    int m_fd = -1;
+    void *m_sqPtr = MAP_FAILED;
+    void *m_cqPtr = MAP_FAILED;
+    void *m_sqes = MAP_FAILED;
+    size_t m_sqSize = 0, m_cqSize = 0, m_sqesSize = 0;
+
+    unsigned *m_sqTail = nullptr, *m_sqArray = nullptr;
+    unsigned m_sqMask = 0, m_localTail = 0;
+
+    unsigned *m_cqHead = nullptr, *m_cqTail = nullptr;
+    unsigned m_cqMask = 0;
+    io_uring_cqe *m_cqes = nullptr;
+};
+
+}
+
+void UringEngine::DirectionStats::add(uint64_t size, uint64_t clatNs)
+{
+    if (ios == 0 || clatNs < clatMinNs) clatMinNs = clatNs;
+    if (clatNs > clatMaxNs) clatMaxNs = clatNs;
+    clatSumNs += clatNs;
+    clat.add(clatNs);
+    bytes += size;
+    ios++;
+}
+
+UringEngine::UringEngine(const Params &params) : m_params(params)
+{
+}
+
+UringEngine::~UringEngine()
+{
+    stop();
+}
+
+void UringEngine::start(std::function<void()> finished)
+{
+    m_stop = false;
+    m_running = true;
+    m_results.assign(std::max(m_params.threads, 1u), JobStats());
+    m_counters.reset(new Counters[m_results.size()]());
+    m_startNs = monotonicNs();
+
+    m_thread = std::thread([this, finished] {
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < m_results.size(); i++) {
+            workers.emplace_back(&UringEngine::runJob, this, std::ref(m_results[i]), i);
+        }
+
+        for (auto &worker : workers) {
+            worker.join();
+        }
+
+        m_running = false;
+        finished();
+    });
+}
+
+void UringEngine::stop()
+{
+    m_stop = true;
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool UringEngine::isRunning() const
+{
+    return m_running;
+}
+
+const UringEngine::Params &UringEngine::params() const
+{
+    return m_params;
+}
+
+const std::vector<UringEngine::JobStats> &UringEngine::results() const
+{
+    return m_results;
+}
+
+std::vector<UringEngine::JobStats> UringEngine::progress() const
+{
+    std::vector<JobStats> progress(m_results.size());
+
+    for (unsigned i = 0; i < progress.size() && m_counters; i++) {
+        DirectionStats *directions[2] = { &progress[i].read, &progress[i].write };
+        for (int d = 0; d < 2; d++) {
+            directions[d]->ios = m_counters[i].ios[d].load(std::memory_order_relaxed);
+            directions[d]->bytes = m_counters[i].bytes[d].load(std::memory_order_relaxed);
+            directions[d]->clatSumNs = m_counters[i].clatSumNs[d].load(std::memory_order_relaxed);
+        }
+        progress[i].runtimeNs = monotonicNs() - m_startNs;
+    }
+
+    return progress;
+}
+
+void UringEngine::publish(const JobStats &stats, unsigned index)
+{
+    const DirectionStats *directions[2] = { &stats.read, &stats.write };
+    for (int d = 0; d < 2; d++) {
+        m_counters[index].ios[d].store(directions[d]->ios, std::memory_order_relaxed);
+        m_counters[index].bytes[d].store(directions[d]->bytes, std::memory_order_relaxed);
+        m_counters[index].clatSumNs[d].store(directions[d]->clatSumNs, std::memory_order_relaxed);
+    }
+}
+
+void UringEngine::runJob(JobStats &stats, unsigned index)
+{
+    const uint32_t bs = m_params.blockSize;
+    const uint32_t depth = std::max(m_params.queueDepth, 1u);
+    const uint64_t blocks = bs ? m_params.fileSize / bs : 0;
+
+    if (blocks == 0) {
+        stats.error = EINVAL;
+        return;
+    }
+
+    // Pinned before anything is allocated, so the ring and buffers land on the job's node
+    if (!m_params.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+
+        for (size_t i = 0; i < m_params.cpus.size(); i++) {
+            int cpu = m_params.cpus[m_params.splitCpus ? index % m_params.cpus.size() : i];
+            if (cpu < 0 || cpu >= CPU_SETSIZE) {
+                stats.error = EINVAL;
+                return;
+            }
+
+            CPU_SET(cpu, &set);
+            if (m_params.splitCpus) break;
+        }
+
+        if (sched_setaffinity(0, sizeof(set), &set) < 0) {
+            stats.error = errno;
+            return;
+        }
+    }
+
+    int flags = (m_params.readPercentage >= 100 ? O_RDONLY : O_RDWR) | (m_params.cacheBypass ? O_DIRECT : 0);
+    int fd = open(m_params.fileName.c_str(), flags);
+    if (fd < 0) {
+        stats.error = errno;
+        return;
+    }
+
+    Ring ring;
+    if (int ret = ring.init(depth); ret < 0) {
+        stats.error = -ret;
+        close(fd);
+        return;
+    }
+
+    uint64_t randomState = std::random_device()() ^ (uint64_t(index + 1) << 32) ^ monotonicNs();
+
+    std::vector<iovec> buffers(depth);
+    for (auto &buffer : buffers) {
+        if (posix_memalign(&buffer.iov_base, 4096, bs) != 0) {
+            buffer.iov_base = nullptr;
+            stats.error = ENOMEM;
+        }
+        else if (m_params.fillZeros) {
+            memset(buffer.iov_base, 0, bs);
+        }
+        else {
+            fillPattern(buffer.iov_base, bs, randomState, m_params.pattern);
+        }
+        buffer.iov_len = bs;
+    }
+
+    // Registration is an optimisation only, fall back to plain reads and writes when the kernel refuses it
+    const bool fixedBuffers = stats.error == 0 && ring.registerBuffers(buffers.data(), depth) == 0;
+    const bool fixedFile = stats.error == 0 && ring.registerFile(fd) == 0;
+
+    struct Slot {
+        uint64_t submitNs;
+        bool read;
+    };
+
+    std::vector<Slot> slots(depth);
+    std::vector<unsigned> freeSlots;
+    std::vector<unsigned> pendingSlots;
+    for (unsigned i = depth; i > 0; i--) freeSlots.push_back(i - 1);
+
+    std::mt19937_64 rng(randomState);
+    std::uniform_int_distribution<uint64_t> blockDistribution(0, blocks - 1);
+    std::uniform_int_distribution<int> mixDistribution(0, 99);
+
+    const uint64_t startNs = monotonicNs();
+    const uint64_t deadlineNs = startNs + uint64_t(m_params.measuringTime) * 1000000000ull;
+
+    uint64_t issued = 0, nextBlock = 0;
+    unsigned inflight = 0;
+    bool wrote = false;
+
+    while (stats.error == 0) {
+        const bool canIssue = !m_stop && issued < blocks && (m_params.measuringTime <= 0 || monotonicNs() < deadlineNs);
+
+        while (canIssue && !freeSlots.empty() && issued < blocks) {
+            unsigned slot = freeSlots.back();
+            freeSlots.pop_back();
+
+            uint64_t block = m_params.random ? blockDistribution(rng) : nextBlock++;
+            bool read = m_params.readPercentage >= 100
+                    || (m_params.readPercentage > 0 && mixDistribution(rng) < m_params.readPercentage);
+
+            if (!read && m_params.continuousGeneration && !m_params.fillZeros) {
+                fillPattern(buffers[slot].iov_base, bs, randomState, m_params.pattern);
+            }
+
+            io_uring_sqe *sqe = ring.nextSqe();
+            if (fixedBuffers) {
+                sqe->opcode = read ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+                sqe->buf_index = slot;
+            }
+            else {
+                sqe->opcode = read ? IORING_OP_READ : IORING_OP_WRITE;
+            }
+            sqe->fd = fixedFile ? 0 : fd;
+            sqe->flags = fixedFile ? IOSQE_FIXED_FILE : 0;
+            sqe->addr = reinterpret_cast<uint64_t>(buffers[slot].iov_base);
+            sqe->len = bs;
+            sqe->off = block * bs;
+            sqe->user_data = slot;
+
+            slots[slot].read = read;
+            wrote |= !read;
+            pendingSlots.push_back(slot);
+            issued++;
+        }
+
+        if (inflight + pendingSlots.size() == 0) break;
+
+        const uint64_t submitNs = monotonicNs();
+        for (unsigned slot : pendingSlots) {
+            slots[slot].submitNs = submitNs;
+        }
+
+        int ret = ring.submitAndWait(pendingSlots.size(), 1);
+        if (ret < 0) {
+            stats.error = -ret;
+            break;
+        }
+
+        // The kernel may take fewer entries than offered, the rest stay queued for the next enter
+        inflight += unsigned(ret);
+        pendingSlots.erase(pendingSlots.begin(), pendingSlots.begin() + ret);
+
+        const uint64_t completionNs = monotonicNs();
+        ring.reap([&] (const io_uring_cqe &cqe) {
+            unsigned slot = unsigned(cqe.user_data);
+            inflight--;
+            freeSlots.push_back(slot);
+
+            if (cqe.res < 0) {
+                stats.error = -cqe.res;
+                return;
+            }
+
+            DirectionStats &direction = slots[slot].read ? stats.read : stats.write;
+            direction.add(uint64_t(cqe.res), completionNs - slots[slot].submitNs);
+        });
+
+        publish(stats, index);
+    }
+
+    // Drain whatever is still in flight or queued after an error so that buffers are not released under the kernel
+    while (inflight + pendingSlots.size() > 0) {
+        int ret = ring.submitAndWait(pendingSlots.size(), 1);
+        if (ret < 0) break;
+
+        inflight += unsigned(ret);
+        pendingSlots.erase(pendingSlots.begin(), pendingSlots.begin() + ret);
+
+        ring.reap([&] (const io_uring_cqe &) { inflight--; });
+    }
+
+    stats.runtimeNs = monotonicNs() - startNs;
+
+    if (wrote && stats.error == 0 && fsync(fd) != 0) {
+        stats.error = errno;
+    }
+
+    close(fd);
+
+    for (auto &buffer : buffers) {
+        free(buffer.iov_base);
+    }
+}
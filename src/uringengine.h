@@ -0,0 +1,96 @@
+#ifndef URINGENGINE_H
+#define URINGENGINE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "latencyhistogram.h"
+#include "randomdata.h"
+
+// Native benchmark engine built directly on io_uring. Every job owns its ring,
+// a registered file and a set of registered buffers, so the hot path does not
+// go through fio and completion times are sampled per I/O.
+class UringEngine
+{
+public:
+    struct Params
+    {
+        std::string fileName;
+        uint64_t fileSize = 0; // bytes
+        int measuringTime = 0; // sec
+        int readPercentage = 100; // 100 for pure reads, 0 for pure writes
+        bool random = false;
+        bool fillZeros = false;
+        DataPattern pattern; // of the written data when not zeros
+        bool cacheBypass = true;
+        bool continuousGeneration = false;
+        uint32_t blockSize = 0; // bytes
+        uint32_t queueDepth = 1;
+        uint32_t threads = 1;
+        std::vector<int> cpus; // CPUs the jobs may run on, empty to leave placement to the scheduler
+        bool splitCpus = false; // pin every job to its own CPU of the set, like fio's cpus_allowed_policy=split
+    };
+
+    struct DirectionStats
+    {
+        uint64_t ios = 0;
+        uint64_t bytes = 0;
+        uint64_t clatSumNs = 0;
+        uint64_t clatMinNs = 0;
+        uint64_t clatMaxNs = 0;
+        LatencyHistogram clat;
+
+        void add(uint64_t size, uint64_t clatNs);
+    };
+
+    struct JobStats
+    {
+        DirectionStats read, write;
+        uint64_t runtimeNs = 0;
+        int error = 0;
+    };
+
+    explicit UringEngine(const Params &params);
+    ~UringEngine();
+
+    UringEngine(const UringEngine&) = delete;
+    UringEngine& operator=(const UringEngine&) = delete;
+
+    // Runs all jobs on a background thread, finished is called from that thread
+    void start(std::function<void()> finished);
+    // Joins the background thread, so it must not be called from finished, only by the owner
+    void stop();
+    bool isRunning() const;
+
+    const Params &params() const;
+    // Only valid once the finished callback has been called
+    const std::vector<JobStats> &results() const;
+    // Running totals that can be sampled while the jobs are in flight, latency extremes and histograms are not tracked
+    std::vector<JobStats> progress() const;
+
+private:
+    struct Counters
+    {
+        std::atomic<uint64_t> ios[2];
+        std::atomic<uint64_t> bytes[2];
+        std::atomic<uint64_t> clatSumNs[2];
+    };
+
+    void runJob(JobStats &stats, unsigned index);
+    void publish(const JobStats &stats, unsigned index);
+
+    Params m_params;
+    std::atomic<bool> m_stop { false };
+    std::atomic<bool> m_running { false };
+    std::atomic<uint64_t> m_startNs { 0 };
+    std::thread m_thread;
+    std::vector<JobStats> m_results;
+    std::unique_ptr<Counters[]> m_counters;
+};
+
+#endif // URINGENGINE_H
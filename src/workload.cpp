@@ -0,0 +1,185 @@
+#include "workload.h"
+
+#include <QObject>
+#include <QRegularExpression>
+
+#include "global.h"
+
+QVariantMap Workload::toVariant() const
+{
+    return {
+        { "name", name },
+        { "rw", rw },
+        { "blockSize", blockSize },
+        { "bsSplit", bsSplit },
+        { "readPercentage", readPercentage },
+        { "queueDepth", queueDepth },
+        { "threads", threads },
+        { "rateIOPS", rateIOPS },
+        { "rateBandwidth", rateBandwidth },
+        { "randomDistribution", randomDistribution },
+        { "fsync", fsync },
+        { "dataSyncOnly", dataSyncOnly },
+        { "duration", duration }
+    };
+}
+
+Workload Workload::fromVariant(const QVariantMap &map)
+{
+    Workload workload;
+
+    workload.name = map.value("name").toString();
+    workload.rw = map.value("rw", workload.rw).toString();
+    workload.blockSize = map.value("blockSize", workload.blockSize).toInt();
+    workload.bsSplit = map.value("bsSplit").toString();
+    workload.readPercentage = map.value("readPercentage", workload.readPercentage).toInt();
+    workload.queueDepth = map.value("queueDepth", workload.queueDepth).toInt();
+    workload.threads = map.value("threads", workload.threads).toInt();
+    workload.rateIOPS = map.value("rateIOPS").toInt();
+    workload.rateBandwidth = map.value("rateBandwidth").toInt();
+    workload.randomDistribution = map.value("randomDistribution", workload.randomDistribution).toString();
+    workload.fsync = map.value("fsync").toInt();
+    workload.dataSyncOnly = map.value("dataSyncOnly").toBool();
+    workload.duration = map.value("duration").toInt();
+
+    return workload;
+}
+
+QVariantMap Workload::jobOptions() const
+{
+    QVariantMap options;
+
+    if (!bsSplit.isEmpty()) options["bssplit"] = bsSplit;
+    if (rateIOPS > 0) options["rate_iops"] = QString::number(rateIOPS);
+    if (rateBandwidth > 0) options["rate"] = QStringLiteral("%1m").arg(rateBandwidth);
+    if (fsync > 0) options[dataSyncOnly ? "fdatasync" : "fsync"] = QString::number(fsync);
+
+    // Non-uniform distributions revisit blocks on purpose, so fio must not track the ones already done
+    if (rw.startsWith(QLatin1String("rand")) && randomDistribution != QLatin1String("random")) {
+        options["random_distribution"] = randomDistribution;
+        options["norandommap"] = "1";
+    }
+
+    return options;
+}
+
+bool Workload::isMixed() const
+{
+    return rw == Global::getRWSequentialMix() || rw == Global::getRWRandomMix();
+}
+
+QString Workload::validate() const
+{
+    if (name.trimmed().isEmpty()) return QObject::tr("The workload has no name.");
+    if (!patterns().contains(rw)) return QObject::tr("Unknown pattern %1.").arg(rw);
+    if (!bsSplit.isEmpty() && !isValidBsSplit(bsSplit)) return QObject::tr("The block size split %1 is not valid.").arg(bsSplit);
+    if (!isValidRandomDistribution(randomDistribution)) return QObject::tr("The random distribution %1 is not valid.").arg(randomDistribution);
+    if (readPercentage < 0 || readPercentage > 100) return QObject::tr("The read percentage must be between 0 and 100.");
+    if (blockSize <= 0 || queueDepth <= 0 || threads <= 0) return QObject::tr("Block size, queue depth and threads must be positive.");
+
+    return {};
+}
+
+QString Workload::description() const
+{
+    QString line = rw;
+
+    if (isMixed()) line += QStringLiteral(" %1/%2").arg(readPercentage).arg(100 - readPercentage);
+
+    line += QStringLiteral(" %1 Q%2T%3").arg(bsSplit.isEmpty() ? Global::formatBlockSize(blockSize) : bsSplit).arg(queueDepth).arg(threads);
+
+    if (rateIOPS > 0) line += QStringLiteral(" ≤%1 IOPS").arg(rateIOPS);
+    if (rateBandwidth > 0) line += QStringLiteral(" ≤%1 MiB/s").arg(rateBandwidth);
+    if (rw.startsWith(QLatin1String("rand")) && randomDistribution != QLatin1String("random")) line += QLatin1Char(' ') + randomDistribution;
+    if (fsync > 0) line += QStringLiteral(" %1/%2").arg(dataSyncOnly ? "fdatasync" : "fsync").arg(fsync);
+
+    return line;
+}
+
+QVector<Workload> Workload::library()
+{
+    QVector<Workload> workloads;
+    Workload workload;
+
+    // Database pages: hot rows are hit far more often, commits flush the data file now and then
+    workload = Workload();
+    workload.name = QObject::tr("OLTP Database");
+    workload.rw = Global::getRWRandomMix();
+    workload.blockSize = 8;
+    workload.readPercentage = 70;
+    workload.queueDepth = 8;
+    workload.threads = 4;
+    workload.randomDistribution = QStringLiteral("zipf:1.1");
+    workload.fsync = 32;
+    workload.dataSyncOnly = true;
+    workloads << workload;
+
+    // Write-ahead log: one writer appends commit groups of varying size and makes each durable.
+    // Logs are preallocated in segments, so the appends are sequential writes into an existing file
+    workload = Workload();
+    workload.name = QObject::tr("Log Append");
+    workload.rw = Global::getRWSequentialWrite();
+    workload.bsSplit = QStringLiteral("4k/40:8k/30:16k/20:64k/10");
+    workload.fsync = 1;
+    workload.dataSyncOnly = true;
+    workloads << workload;
+
+    // Guest file systems issue a mix of small and medium requests from several vCPUs
+    workload = Workload();
+    workload.name = QObject::tr("VM Image");
+    workload.rw = Global::getRWRandomMix();
+    workload.bsSplit = QStringLiteral("4k/50:8k/15:16k/15:32k/10:64k/10");
+    workload.readPercentage = 60;
+    workload.queueDepth = 16;
+    workload.threads = 4;
+    workloads << workload;
+
+    // Compilers read many small sources and headers, the common headers over and over
+    workload = Workload();
+    workload.name = QObject::tr("Build Tree");
+    workload.rw = Global::getRWRandomRead();
+    workload.bsSplit = QStringLiteral("4k/60:16k/30:64k/10");
+    workload.queueDepth = 2;
+    workload.threads = 8;
+    workload.randomDistribution = QStringLiteral("zipf:1.2");
+    workloads << workload;
+
+    // Cameras and capture cards stream large sequential writes
+    workload = Workload();
+    workload.name = QObject::tr("Media Ingest");
+    workload.rw = Global::getRWSequentialWrite();
+    workload.blockSize = 1024;
+    workload.queueDepth = 4;
+    workload.threads = 2;
+    workloads << workload;
+
+    return workloads;
+}
+
+QStringList Workload::patterns()
+{
+    return { Global::getRWSequentialRead(), Global::getRWSequentialWrite(), Global::getRWSequentialMix(),
+             Global::getRWRandomRead(), Global::getRWRandomWrite(), Global::getRWRandomMix() };
+}
+
+bool Workload::isValidBsSplit(const QString &bsSplit)
+{
+    static const QRegularExpression format(QStringLiteral("^\\d+[kKmM]?/\\d{1,3}(:\\d+[kKmM]?/\\d{1,3})*$"));
+
+    if (!format.match(bsSplit).hasMatch()) return false;
+
+    // fio fills up a split below 100% with the last block size, but more than 100% is an error
+    int total = 0;
+    for (const QString &entry : bsSplit.split(QLatin1Char(':'))) {
+        total += entry.section(QLatin1Char('/'), 1).toInt();
+    }
+
+    return total <= 100;
+}
+
+bool Workload::isValidRandomDistribution(const QString &distribution)
+{
+    static const QRegularExpression format(QStringLiteral("^(random|(zipf|pareto|normal):\\d+(\\.\\d+)?)$"));
+
+    return format.match(distribution).hasMatch();
+}
@@ -0,0 +1,45 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <QString>
+#include <QVariantMap>
+#include <QVector>
+
+// A user defined job, run in place of or next to the four fixed tests.
+// Everything the fixed tests don't cover travels to the helper as fio job options.
+struct Workload
+{
+    QString name;
+    QString rw = QStringLiteral("randrw"); // fio pattern
+    int blockSize = 4; // KiB, unused when bsSplit is set
+    QString bsSplit; // fio bssplit, e.g. 4k/60:16k/30:64k/10
+    int readPercentage = 70; // of the mixed patterns
+    int queueDepth = 1;
+    int threads = 1;
+    int rateIOPS = 0; // per job and direction, 0 is unlimited
+    int rateBandwidth = 0; // MiB/s per job and direction, 0 is unlimited
+    QString randomDistribution = QStringLiteral("random"); // fio random_distribution
+    int fsync = 0; // fsync after this many writes, 0 never
+    bool dataSyncOnly = false; // fdatasync in place of fsync
+    int duration = 0; // sec, 0 for the measuring time of the settings
+
+    QVariantMap toVariant() const;
+    static Workload fromVariant(const QVariantMap &map);
+
+    // Options for Helper::startBenchmarkTest, on top of its fixed arguments
+    QVariantMap jobOptions() const;
+    bool isMixed() const;
+    // Empty when the workload can be run
+    QString validate() const;
+    // One line for lists and reports, e.g. "randrw 70/30 4 KiB Q1T1"
+    QString description() const;
+
+    // Built-in workloads modelled on common application I/O
+    static QVector<Workload> library();
+
+    static QStringList patterns();
+    static bool isValidBsSplit(const QString &bsSplit);
+    static bool isValidRandomDistribution(const QString &distribution);
+};
+
+#endif // WORKLOAD_H
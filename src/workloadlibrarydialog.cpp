@@ -0,0 +1,136 @@
+#include "workloadlibrarydialog.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QLabel>
+#include <QVBoxLayout>
+
+namespace {
+constexpr int CardColumns = 3;
+}
+
+WorkloadLibraryDialog::WorkloadLibraryDialog(Benchmark *benchmark, QWidget *parent)
+    : ToolDialog(benchmark, parent)
+{
+    setWindowTitle(tr("Workload Library"));
+
+    QGridLayout *cardsLayout = new QGridLayout;
+
+    for (const Workload &workload : Workload::library()) {
+        Card card;
+        card.workload = workload;
+        card.box = new QGroupBox(workload.name, this);
+        card.result = new QLabel(this);
+
+        // Unchecked cards are skipped by the next run
+        card.box->setCheckable(true);
+        card.box->setChecked(true);
+
+        QLabel *description = new QLabel(workload.description(), this);
+        description->setWordWrap(true);
+        description->setEnabled(false);
+
+        QFont font = card.result->font();
+        font.setPointSizeF(font.pointSizeF() * 1.5);
+        card.result->setFont(font);
+        card.result->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+        QVBoxLayout *boxLayout = new QVBoxLayout(card.box);
+        boxLayout->addWidget(description);
+        boxLayout->addWidget(card.result);
+        boxLayout->addStretch();
+
+        cardsLayout->addWidget(card.box, m_cards.size() / CardColumns, m_cards.size() % CardColumns);
+
+        m_cards << card;
+        updateCard(m_cards.last());
+    }
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(cardsLayout, 1);
+    layout->addLayout(createButtonLayout());
+}
+
+void WorkloadLibraryDialog::updateCard(Card &card)
+{
+    if (!card.measured) {
+        card.result->setText(QStringLiteral("–"));
+        return;
+    }
+
+    const Benchmark::PerformanceResult &result = card.performance;
+
+    card.result->setText(tr("%1 MB/s\n%2 IOPS\n%3 μs, p99 %4 μs")
+                         .arg(result.Bandwidth, 0, 'f', 1).arg(result.IOPS, 0, 'f', 0)
+                         .arg(result.Latency, 0, 'f', 1).arg(result.percentile(99), 0, 'f', 1));
+}
+
+void WorkloadLibraryDialog::setInputsEnabled(bool enabled)
+{
+    for (Card &card : m_cards) card.box->setEnabled(enabled || card.box->isChecked());
+}
+
+bool WorkloadLibraryDialog::prepareRun()
+{
+    m_selected.clear();
+
+    for (int i = 0; i < m_cards.size(); i++) {
+        Card &card = m_cards[i];
+
+        if (!card.box->isChecked()) continue;
+
+        card.measured = false;
+        updateCard(card);
+        m_selected << i;
+    }
+
+    return !m_selected.isEmpty();
+}
+
+bool WorkloadLibraryDialog::run()
+{
+    for (int i = 0; i < m_selected.size(); i++) {
+        Card &card = m_cards[m_selected.at(i)];
+        const Workload &workload = card.workload;
+
+        m_status->setText(tr("Running %1 of %2").arg(i + 1).arg(m_selected.size()));
+
+        Benchmark::TestSpec spec { workload.rw, workload.blockSize, workload.queueDepth, workload.threads, workload.jobOptions() };
+        spec.measuringTime = workload.duration;
+        spec.readPercentage = workload.readPercentage;
+
+        if (!m_benchmark->measure(spec, card.performance, tr("%1 (%2/%3)").arg(workload.name).arg(i + 1).arg(m_selected.size()))) return false;
+
+        card.measured = true;
+        updateCard(card);
+    }
+
+    return true;
+}
+
+bool WorkloadLibraryDialog::hasResults() const
+{
+    for (const Card &card : m_cards) {
+        if (card.measured) return true;
+    }
+
+    return false;
+}
+
+void WorkloadLibraryDialog::copyResults()
+{
+    QStringList lines { QStringLiteral("workload,job,mb_s,iops,latency_us,p99_us") };
+
+    for (const Card &card : m_cards) {
+        if (!card.measured) continue;
+
+        const Benchmark::PerformanceResult &result = card.performance;
+        lines << QStringLiteral("\"%1\",\"%2\",%3,%4,%5,%6").arg(card.workload.name, card.workload.description())
+                 .arg(result.Bandwidth, 0, 'f', 3).arg(result.IOPS, 0, 'f', 3)
+                 .arg(result.Latency, 0, 'f', 3).arg(result.percentile(99), 0, 'f', 3);
+    }
+
+    QApplication::clipboard()->setText(lines.join('\n'));
+}
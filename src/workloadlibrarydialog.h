@@ -0,0 +1,43 @@
+#ifndef WORKLOADLIBRARYDIALOG_H
+#define WORKLOADLIBRARYDIALOG_H
+
+#include <QVector>
+
+#include "tooldialog.h"
+#include "workload.h"
+
+class QGroupBox;
+class QLabel;
+
+// Runs the built-in workloads, each with its own result card
+class WorkloadLibraryDialog : public ToolDialog
+{
+    Q_OBJECT
+
+public:
+    explicit WorkloadLibraryDialog(Benchmark *benchmark, QWidget *parent = nullptr);
+
+private:
+    struct Card
+    {
+        Workload workload;
+        QGroupBox *box;
+        QLabel *result;
+        bool measured = false;
+        Benchmark::PerformanceResult performance;
+    };
+
+    void updateCard(Card &card);
+
+    // Cards left out of the run are greyed out while it goes on
+    void setInputsEnabled(bool enabled) override;
+    bool prepareRun() override;
+    bool run() override;
+    bool hasResults() const override;
+    void copyResults() override;
+
+    QVector<Card> m_cards;
+    QVector<int> m_selected; // cards of the current run
+};
+
+#endif // WORKLOADLIBRARYDIALOG_H
@@ -0,0 +1,333 @@
+#include "workloadsdialog.h"
+
+#include <QApplication>
+#include <QCheckBox>
+#include <QClipboard>
+#include <QComboBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QMenu>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QRegularExpressionValidator>
+#include <QSpinBox>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "appsettings.h"
+
+WorkloadsDialog::WorkloadsDialog(Benchmark *benchmark, QWidget *parent)
+    : ToolDialog(benchmark, parent)
+    , m_list(new QListWidget(this))
+    , m_addButton(new QPushButton(tr("Add"), this))
+    , m_libraryButton(new QPushButton(tr("From Library"), this))
+    , m_removeButton(new QPushButton(tr("Remove"), this))
+    , m_editor(new QWidget(this))
+    , m_name(new QLineEdit(this))
+    , m_pattern(createPatternCombo())
+    , m_blockSize(createBlockSizeCombo())
+    , m_bsSplit(new QLineEdit(this))
+    , m_readPercentage(new QSpinBox(this))
+    , m_queueDepth(createQueueDepthCombo())
+    , m_threads(new QSpinBox(this))
+    , m_rateIOPS(new QSpinBox(this))
+    , m_rateBandwidth(new QSpinBox(this))
+    , m_randomDistribution(new QLineEdit(this))
+    , m_fsync(new QSpinBox(this))
+    , m_dataSyncOnly(new QCheckBox(tr("Data only (fdatasync)"), this))
+    , m_duration(new QSpinBox(this))
+    , m_table(new QTreeWidget(this))
+{
+    setWindowTitle(tr("Custom Workloads"));
+
+    m_startButton->setText(tr("Run All"));
+
+    m_bsSplit->setPlaceholderText(tr("Single block size"));
+    m_bsSplit->setToolTip(tr("Block sizes with their share of the I/Os, e.g. 4k/60:16k/30:64k/10. Overrides the block size."));
+    m_bsSplit->setValidator(new QRegularExpressionValidator(QRegularExpression(QStringLiteral("^[0-9kKmM/:]*$")), this));
+
+    m_readPercentage->setRange(0, 100);
+    m_readPercentage->setSuffix(QStringLiteral("%"));
+    m_readPercentage->setToolTip(tr("Share of reads in the mixed patterns"));
+
+    m_threads->setRange(1, 64);
+
+    m_rateIOPS->setRange(0, 10000000);
+    m_rateIOPS->setSpecialValueText(tr("Unlimited"));
+    m_rateIOPS->setToolTip(tr("Per thread and direction"));
+
+    m_rateBandwidth->setRange(0, 100000);
+    m_rateBandwidth->setSuffix(tr(" MiB/s"));
+    m_rateBandwidth->setSpecialValueText(tr("Unlimited"));
+    m_rateBandwidth->setToolTip(tr("Per thread and direction"));
+
+    m_randomDistribution->setToolTip(tr("random, zipf:θ, pareto:h or normal:σ%, only used by the random patterns"));
+    m_randomDistribution->setValidator(new QRegularExpressionValidator(QRegularExpression(QStringLiteral("^[a-z]*(:[0-9.]*)?$")), this));
+
+    m_fsync->setRange(0, 999999);
+    m_fsync->setPrefix(tr("every "));
+    m_fsync->setSuffix(tr(" writes"));
+    m_fsync->setSpecialValueText(tr("Never"));
+
+    m_duration->setRange(0, 3600);
+    m_duration->setSuffix(tr(" sec"));
+    m_duration->setSpecialValueText(tr("Measuring time"));
+
+    // Starting points that are tuned further here
+    QMenu *libraryMenu = new QMenu(this);
+    for (const Workload &workload : Workload::library()) {
+        libraryMenu->addAction(workload.name, this, [this, workload] { addLibraryWorkload(workload); });
+    }
+    m_libraryButton->setMenu(libraryMenu);
+
+    m_table->setRootIsDecorated(false);
+    m_table->setHeaderLabels({ tr("Workload"), tr("Job"), tr("MB/s"), tr("IOPS"), tr("μs"), tr("p99 μs") });
+
+    QHBoxLayout *syncLayout = new QHBoxLayout;
+    syncLayout->addWidget(m_fsync, 1);
+    syncLayout->addWidget(m_dataSyncOnly);
+
+    QFormLayout *formLayout = new QFormLayout(m_editor);
+    formLayout->setContentsMargins(0, 0, 0, 0);
+    formLayout->addRow(tr("Name:"), m_name);
+    formLayout->addRow(tr("Pattern:"), m_pattern);
+    formLayout->addRow(tr("Block size:"), m_blockSize);
+    formLayout->addRow(tr("Block size split:"), m_bsSplit);
+    formLayout->addRow(tr("Reads:"), m_readPercentage);
+    formLayout->addRow(tr("Queue depth:"), m_queueDepth);
+    formLayout->addRow(tr("Threads:"), m_threads);
+    formLayout->addRow(tr("IOPS limit:"), m_rateIOPS);
+    formLayout->addRow(tr("Bandwidth limit:"), m_rateBandwidth);
+    formLayout->addRow(tr("Random distribution:"), m_randomDistribution);
+    formLayout->addRow(tr("fsync:"), syncLayout);
+    formLayout->addRow(tr("Duration:"), m_duration);
+
+    QHBoxLayout *listButtonLayout = new QHBoxLayout;
+    listButtonLayout->addWidget(m_addButton);
+    listButtonLayout->addWidget(m_libraryButton);
+    listButtonLayout->addWidget(m_removeButton);
+
+    QVBoxLayout *listLayout = new QVBoxLayout;
+    listLayout->addWidget(m_list, 1);
+    listLayout->addLayout(listButtonLayout);
+
+    QHBoxLayout *editLayout = new QHBoxLayout;
+    editLayout->addLayout(listLayout);
+    editLayout->addWidget(m_editor, 1);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(editLayout);
+    layout->addWidget(m_table, 1);
+    layout->addLayout(createButtonLayout());
+
+    m_workloads = AppSettings().getWorkloads();
+
+    for (const Workload &workload : m_workloads) {
+        m_list->addItem(workload.name);
+    }
+
+    connect(m_list, &QListWidget::currentRowChanged, this, &WorkloadsDialog::loadWorkload);
+    connect(m_addButton, &QPushButton::clicked, this, &WorkloadsDialog::addWorkload);
+    connect(m_removeButton, &QPushButton::clicked, this, &WorkloadsDialog::removeWorkload);
+
+    for (QLineEdit *edit : { m_name, m_bsSplit, m_randomDistribution }) {
+        connect(edit, &QLineEdit::textEdited, this, &WorkloadsDialog::storeWorkload);
+    }
+
+    for (QComboBox *combo : { m_pattern, m_blockSize, m_queueDepth }) {
+        connect(combo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &WorkloadsDialog::storeWorkload);
+    }
+
+    for (QSpinBox *spin : { m_readPercentage, m_threads, m_rateIOPS, m_rateBandwidth, m_fsync, m_duration }) {
+        connect(spin, QOverload<int>::of(&QSpinBox::valueChanged), this, &WorkloadsDialog::storeWorkload);
+    }
+
+    connect(m_dataSyncOnly, &QCheckBox::toggled, this, &WorkloadsDialog::storeWorkload);
+
+    m_list->setCurrentRow(m_workloads.isEmpty() ? -1 : 0);
+    loadWorkload(m_list->currentRow());
+    m_startButton->setEnabled(!m_workloads.isEmpty());
+}
+
+void WorkloadsDialog::addWorkload()
+{
+    Workload workload;
+    workload.name = tr("Workload %1").arg(m_workloads.size() + 1);
+
+    addLibraryWorkload(workload);
+}
+
+void WorkloadsDialog::addLibraryWorkload(const Workload &workload)
+{
+    m_workloads << workload;
+    m_list->addItem(workload.name);
+    m_list->setCurrentRow(m_workloads.size() - 1);
+
+    AppSettings().setWorkloads(m_workloads);
+    m_startButton->setEnabled(!m_running);
+}
+
+void WorkloadsDialog::removeWorkload()
+{
+    const int row = m_list->currentRow();
+    if (row < 0) return;
+
+    m_workloads.removeAt(row);
+    delete m_list->takeItem(row);
+
+    AppSettings().setWorkloads(m_workloads);
+    m_startButton->setEnabled(!m_running && !m_workloads.isEmpty());
+}
+
+void WorkloadsDialog::loadWorkload(int row)
+{
+    m_editor->setEnabled(row >= 0 && !m_running);
+    m_removeButton->setEnabled(row >= 0 && !m_running);
+
+    if (row < 0) return;
+
+    const Workload &workload = m_workloads.at(row);
+
+    m_loading = true;
+
+    m_name->setText(workload.name);
+    m_pattern->setCurrentIndex(qMax(0, m_pattern->findData(workload.rw)));
+    m_blockSize->setCurrentIndex(qMax(0, m_blockSize->findData(workload.blockSize)));
+    m_bsSplit->setText(workload.bsSplit);
+    m_readPercentage->setValue(workload.readPercentage);
+    m_queueDepth->setCurrentIndex(qMax(0, m_queueDepth->findData(workload.queueDepth)));
+    m_threads->setValue(workload.threads);
+    m_rateIOPS->setValue(workload.rateIOPS);
+    m_rateBandwidth->setValue(workload.rateBandwidth);
+    m_randomDistribution->setText(workload.randomDistribution);
+    m_fsync->setValue(workload.fsync);
+    m_dataSyncOnly->setChecked(workload.dataSyncOnly);
+    m_duration->setValue(workload.duration);
+
+    m_loading = false;
+
+    m_readPercentage->setEnabled(workload.isMixed());
+    m_randomDistribution->setEnabled(workload.rw.startsWith(QLatin1String("rand")));
+}
+
+void WorkloadsDialog::storeWorkload()
+{
+    const int row = m_list->currentRow();
+    if (m_loading || row < 0) return;
+
+    Workload &workload = m_workloads[row];
+
+    workload.name = m_name->text();
+    workload.rw = m_pattern->currentData().toString();
+    workload.blockSize = m_blockSize->currentData().toInt();
+    workload.bsSplit = m_bsSplit->text();
+    workload.readPercentage = m_readPercentage->value();
+    workload.queueDepth = m_queueDepth->currentData().toInt();
+    workload.threads = m_threads->value();
+    workload.rateIOPS = m_rateIOPS->value();
+    workload.rateBandwidth = m_rateBandwidth->value();
+    workload.randomDistribution = m_randomDistribution->text().isEmpty() ? QStringLiteral("random") : m_randomDistribution->text();
+    workload.fsync = m_fsync->value();
+    workload.dataSyncOnly = m_dataSyncOnly->isChecked();
+    workload.duration = m_duration->value();
+
+    m_list->item(row)->setText(workload.name);
+    m_readPercentage->setEnabled(workload.isMixed());
+    m_randomDistribution->setEnabled(workload.rw.startsWith(QLatin1String("rand")));
+
+    AppSettings().setWorkloads(m_workloads);
+}
+
+void WorkloadsDialog::setInputsEnabled(bool enabled)
+{
+    m_list->setEnabled(enabled);
+    m_addButton->setEnabled(enabled);
+    m_libraryButton->setEnabled(enabled);
+    m_removeButton->setEnabled(enabled && m_list->currentRow() >= 0);
+    m_editor->setEnabled(enabled && m_list->currentRow() >= 0);
+}
+
+bool WorkloadsDialog::canStart() const
+{
+    return !m_workloads.isEmpty();
+}
+
+void WorkloadsDialog::updateResults()
+{
+    m_table->clear();
+
+    for (int i = 0; i < m_results.size(); i++) {
+        const Benchmark::PerformanceResult &result = m_results.at(i);
+
+        m_table->addTopLevelItem(new QTreeWidgetItem({
+            m_ran.at(i).name,
+            m_ran.at(i).description(),
+            QString::number(result.Bandwidth, 'f', 1),
+            QString::number(result.IOPS, 'f', 0),
+            QString::number(result.Latency, 'f', 1),
+            QString::number(result.percentile(99), 'f', 1)
+        }));
+    }
+}
+
+bool WorkloadsDialog::prepareRun()
+{
+    for (const Workload &workload : m_workloads) {
+        QString error = workload.validate();
+        if (!error.isEmpty()) {
+            QMessageBox::critical(this, tr("Invalid workload"), QStringLiteral("%1: %2").arg(workload.name, error));
+            return false;
+        }
+    }
+
+    m_ran = m_workloads;
+    m_results.clear();
+
+    updateResults();
+
+    return true;
+}
+
+bool WorkloadsDialog::run()
+{
+    for (int i = 0; i < m_ran.size(); i++) {
+        const Workload &workload = m_ran.at(i);
+
+        m_status->setText(tr("Running %1 of %2").arg(i + 1).arg(m_ran.size()));
+
+        Benchmark::TestSpec spec { workload.rw, workload.blockSize, workload.queueDepth, workload.threads, workload.jobOptions() };
+        spec.measuringTime = workload.duration;
+        spec.readPercentage = workload.readPercentage;
+
+        Benchmark::PerformanceResult result;
+        if (!m_benchmark->measure(spec, result, tr("%1 (%2/%3)").arg(workload.name).arg(i + 1).arg(m_ran.size()))) return false;
+
+        m_results << result;
+
+        updateResults();
+    }
+
+    return true;
+}
+
+bool WorkloadsDialog::hasResults() const
+{
+    return !m_results.isEmpty();
+}
+
+void WorkloadsDialog::copyResults()
+{
+    QStringList lines { QStringLiteral("workload,job,mb_s,iops,latency_us,p99_us") };
+
+    for (int i = 0; i < m_results.size(); i++) {
+        const Benchmark::PerformanceResult &result = m_results.at(i);
+        lines << QStringLiteral("\"%1\",\"%2\",%3,%4,%5,%6").arg(m_ran.at(i).name, m_ran.at(i).description())
+                 .arg(result.Bandwidth, 0, 'f', 3).arg(result.IOPS, 0, 'f', 3)
+                 .arg(result.Latency, 0, 'f', 3).arg(result.percentile(99), 0, 'f', 3);
+    }
+
+    QApplication::clipboard()->setText(lines.join('\n'));
+}
@@ -0,0 +1,69 @@
+#ifndef WORKLOADSDIALOG_H
+#define WORKLOADSDIALOG_H
+
+#include <QVector>
+
+#include "tooldialog.h"
+#include "workload.h"
+
+class QCheckBox;
+class QComboBox;
+class QLineEdit;
+class QListWidget;
+class QPushButton;
+class QSpinBox;
+class QTreeWidget;
+class QWidget;
+
+// Edits the user defined workloads kept in the settings and runs them one after another
+class WorkloadsDialog : public ToolDialog
+{
+    Q_OBJECT
+
+public:
+    explicit WorkloadsDialog(Benchmark *benchmark, QWidget *parent = nullptr);
+
+private slots:
+    void addWorkload();
+    void addLibraryWorkload(const Workload &workload);
+    void removeWorkload();
+    void loadWorkload(int row);
+    void storeWorkload();
+
+private:
+    void setInputsEnabled(bool enabled) override;
+    bool canStart() const override;
+    bool prepareRun() override;
+    bool run() override;
+    bool hasResults() const override;
+    void copyResults() override;
+
+    void updateResults();
+
+    QListWidget *m_list;
+    QPushButton *m_addButton;
+    QPushButton *m_libraryButton;
+    QPushButton *m_removeButton;
+    QWidget *m_editor;
+    QLineEdit *m_name;
+    QComboBox *m_pattern;
+    QComboBox *m_blockSize;
+    QLineEdit *m_bsSplit;
+    QSpinBox *m_readPercentage;
+    QComboBox *m_queueDepth;
+    QSpinBox *m_threads;
+    QSpinBox *m_rateIOPS;
+    QSpinBox *m_rateBandwidth;
+    QLineEdit *m_randomDistribution;
+    QSpinBox *m_fsync;
+    QCheckBox *m_dataSyncOnly;
+    QSpinBox *m_duration;
+    QTreeWidget *m_table;
+
+    bool m_loading = false;
+    QVector<Workload> m_workloads;
+    QVector<Workload> m_ran;
+    QVector<Benchmark::PerformanceResult> m_results;
+};
+
+#endif // WORKLOADSDIALOG_H